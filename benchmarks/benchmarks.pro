@@ -0,0 +1,11 @@
+# Benchmarks of the file manager engines, built apart from the application:
+#     qmake benchmarks/benchmarks.pro && make
+# Every driver prints its results as JSON, see the comment on top of its main().
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    gendir \
+    engines \
+    pinyin \
+    diskmount
@@ -0,0 +1,10 @@
+# The sources and build settings of dde-file-manager, without its main(),
+# so that the engines can be driven by a benchmark instead of the UI.
+
+APP_ROOT = $$PWD/../..
+
+DEFINES += QMAKE_TARGET=\\\"dde-file-manager\\\" QMAKE_VERSION=\\\"benchmark\\\"
+DEFINES += QMAKE_ORGANIZATION_NAME=\\\"deepin\\\"
+DEFINES += APPSHAREDIR=\\\"/usr/share/dde-file-manager\\\"
+
+include($$APP_ROOT/dde-file-manager.pri)
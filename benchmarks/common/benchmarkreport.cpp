@@ -0,0 +1,127 @@
+#include "benchmarkreport.h"
+
+#include <algorithm>
+#include <cmath>
+
+BenchmarkReport::BenchmarkReport(const QString &name)
+    : m_name(name)
+{
+
+}
+
+QString BenchmarkReport::name() const
+{
+    return m_name;
+}
+
+void BenchmarkReport::start()
+{
+    m_timer.start();
+}
+
+void BenchmarkReport::stop()
+{
+    if (m_timer.isValid())
+        m_elapsed += m_timer.nsecsElapsed();
+
+    m_timer.invalidate();
+}
+
+qint64 BenchmarkReport::elapsedNsecs() const
+{
+    return m_elapsed;
+}
+
+void BenchmarkReport::addItems(qint64 count)
+{
+    m_items += count;
+}
+
+void BenchmarkReport::addBytes(qint64 count)
+{
+    m_bytes += count;
+}
+
+void BenchmarkReport::addSample(qint64 nsecs)
+{
+    m_samples.append(nsecs);
+}
+
+void BenchmarkReport::setValue(const QString &key, const QJsonValue &value)
+{
+    m_values[key] = value;
+}
+
+void BenchmarkReport::setFailed(const QString &reason)
+{
+    m_failure = reason;
+}
+
+bool BenchmarkReport::isFailed() const
+{
+    return !m_failure.isEmpty();
+}
+
+/// nearest rank, \a p in [0, 1]
+double BenchmarkReport::percentile(const QVector<qint64> &sortedSamples, double p)
+{
+    if (sortedSamples.isEmpty())
+        return 0;
+
+    int rank = qBound(0, int(std::ceil(p * sortedSamples.size())) - 1, sortedSamples.size() - 1);
+
+    return sortedSamples.at(rank);
+}
+
+QJsonObject BenchmarkReport::toJson() const
+{
+    QJsonObject object;
+    double seconds = m_elapsed / 1e9;
+
+    object["name"] = m_name;
+    object["elapsedMs"] = m_elapsed / 1e6;
+    object["items"] = m_items;
+
+    if (seconds > 0 && m_items > 0)
+        object["itemsPerSecond"] = m_items / seconds;
+
+    if (m_bytes > 0) {
+        object["bytes"] = m_bytes;
+
+        if (seconds > 0)
+            object["bytesPerSecond"] = m_bytes / seconds;
+    }
+
+    if (!m_samples.isEmpty()) {
+        QVector<qint64> samples = m_samples;
+        qint64 sum = 0;
+
+        std::sort(samples.begin(), samples.end());
+
+        for (qint64 sample : samples) {
+            sum += sample;
+        }
+
+        QJsonObject latency;
+
+        /// all latencies are in microseconds
+        latency["count"] = samples.size();
+        latency["min"] = samples.first() / 1e3;
+        latency["mean"] = sum / 1e3 / samples.size();
+        latency["p50"] = percentile(samples, 0.5) / 1e3;
+        latency["p90"] = percentile(samples, 0.9) / 1e3;
+        latency["p99"] = percentile(samples, 0.99) / 1e3;
+        latency["max"] = samples.last() / 1e3;
+
+        object["latencyUs"] = latency;
+    }
+
+    for (auto it = m_values.constBegin(); it != m_values.constEnd(); ++it) {
+        object[it.key()] = it.value();
+    }
+
+    if (!m_failure.isEmpty())
+        object["failed"] = m_failure;
+
+    return object;
+}
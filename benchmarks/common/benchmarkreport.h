@@ -0,0 +1,70 @@
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+#include <QElapsedTimer>
+
+/// Collects the result of one benchmark: how many items were processed in
+/// how long, and the latency of the individual steps.
+class BenchmarkReport
+{
+public:
+    explicit BenchmarkReport(const QString &name);
+
+    QString name() const;
+
+    void start();
+    void stop();
+    qint64 elapsedNsecs() const;
+
+    void addItems(qint64 count);
+    void addBytes(qint64 count);
+    void addSample(qint64 nsecs);
+    void setValue(const QString &key, const QJsonValue &value);
+    void setFailed(const QString &reason);
+
+    bool isFailed() const;
+
+    QJsonObject toJson() const;
+
+    static double percentile(const QVector<qint64> &sortedSamples, double p);
+
+private:
+    QString m_name;
+    QElapsedTimer m_timer;
+    qint64 m_elapsed = 0;
+    qint64 m_items = 0;
+    qint64 m_bytes = 0;
+    QVector<qint64> m_samples;
+    QJsonObject m_values;
+    QString m_failure;
+};
+
+/// Measures the time between two points, or since the last lap
+class Stopwatch
+{
+public:
+    inline Stopwatch()
+    { m_timer.start();}
+
+    inline qint64 lap()
+    {
+        qint64 now = m_timer.nsecsElapsed();
+        qint64 lap = now - m_last;
+
+        m_last = now;
+
+        return lap;
+    }
+
+    inline qint64 elapsed() const
+    { return m_timer.nsecsElapsed();}
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_last = 0;
+};
+
+#endif // BENCHMARKREPORT_H
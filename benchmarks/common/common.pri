@@ -0,0 +1,9 @@
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/benchmarkreport.h \
+    $$PWD/treegenerator.h
+
+SOURCES += \
+    $$PWD/benchmarkreport.cpp \
+    $$PWD/treegenerator.cpp
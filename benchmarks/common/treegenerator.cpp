@@ -0,0 +1,201 @@
+#include "treegenerator.h"
+
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define WRITE_BLOCK_SIZE 65536
+
+static const char *asciiWords[] = {
+    "report", "photo", "draft", "backup", "notes", "invoice", "song", "video",
+    "readme", "build", "archive", "scan", "slides", "budget", "diary", "patch"
+};
+
+static const char *extensions[] = {
+    ".txt", ".jpg", ".png", ".pdf", ".doc", ".mp3", ".mp4", ".tar.gz", ".cpp", ""
+};
+
+TreeGenerator::TreeGenerator(quint32 seed)
+    : m_seed(seed)
+{
+
+}
+
+void TreeGenerator::setNameStyle(TreeGenerator::NameStyle style)
+{
+    m_nameStyle = style;
+}
+
+void TreeGenerator::setSizeStyle(TreeGenerator::SizeStyle style)
+{
+    m_sizeStyle = style;
+}
+
+void TreeGenerator::setMaxBytes(qint64 bytes)
+{
+    m_maxBytes = bytes;
+}
+
+bool TreeGenerator::generateFlat(const QString &dirPath, int count)
+{
+    if (!QDir().mkpath(dirPath))
+        return false;
+
+    ++m_statistics.directories;
+
+    for (int i = 0; i < count; ++i) {
+        if (!createFile(dirPath + QDir::separator() + fileName(i), fileSize()))
+            return false;
+    }
+
+    return true;
+}
+
+bool TreeGenerator::generateTree(const QString &dirPath, int depth, int fanout, int filesPerDir)
+{
+    if (!QDir().mkpath(dirPath))
+        return false;
+
+    ++m_statistics.directories;
+
+    return generateLevel(dirPath, depth, fanout, filesPerDir);
+}
+
+TreeGenerator::Statistics TreeGenerator::statistics() const
+{
+    return m_statistics;
+}
+
+QString TreeGenerator::fileName(int index)
+{
+    QString name;
+    NameStyle style = m_nameStyle;
+
+    if (style == MixedNames)
+        style = random() % 3 == 0 ? CjkNames : AsciiNames;
+
+    if (style == CjkNames) {
+        /// common CJK unified ideographs, plus a few kana and hangul
+        int length = 2 + random() % 6;
+
+        for (int i = 0; i < length; ++i) {
+            switch (random() % 8) {
+            case 0:
+                name.append(QChar(ushort(0x3042 + random() % 80)));
+                break;
+            case 1:
+                name.append(QChar(ushort(0xac00 + random() % 2000)));
+                break;
+            default:
+                name.append(QChar(ushort(0x4e00 + random() % 0x51a5)));
+                break;
+            }
+        }
+    } else {
+        name = QString::fromLatin1(asciiWords[random() % (sizeof(asciiWords) / sizeof(asciiWords[0]))]);
+
+        if (random() % 2)
+            name[0] = name.at(0).toUpper();
+    }
+
+    /// the index keeps names unique, it also makes natural sorting matter
+    name += QString("_%1").arg(index);
+    name += QString::fromLatin1(extensions[random() % (sizeof(extensions) / sizeof(extensions[0]))]);
+
+    return name;
+}
+
+quint32 TreeGenerator::random()
+{
+    m_seed = m_seed * 1103515245 + 12345;
+
+    return (m_seed >> 16) & 0x7fff;
+}
+
+qint64 TreeGenerator::fileSize()
+{
+    if (m_sizeStyle == EmptyFiles || m_statistics.bytes >= m_maxBytes)
+        return 0;
+
+    /// mostly small files, some of a few MiB and rarely a big one
+    quint32 dice = random() % 100;
+
+    if (dice < 70)
+        return random() % 4096;
+
+    if (dice < 95)
+        return qint64(random() % 1024) << 10;
+
+    if (dice < 99)
+        return qint64(1 + random() % 8) << 20;
+
+    return qint64(32 + random() % 32) << 20;
+}
+
+bool TreeGenerator::createFile(const QString &filePath, qint64 size)
+{
+    int fd = ::open(QFile::encodeName(filePath).constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (fd < 0) {
+        qWarning() << "Couldn't create" << filePath;
+
+        return false;
+    }
+
+    char block[WRITE_BLOCK_SIZE];
+    qint64 written = 0;
+
+    /// real data, so that copies can't take a shortcut over holes
+    for (int i = 0; size > 0 && i < WRITE_BLOCK_SIZE; ++i) {
+        block[i] = char(random());
+    }
+
+    while (written < size) {
+        ssize_t count = ::write(fd, block, qMin(size - written, qint64(WRITE_BLOCK_SIZE)));
+
+        if (count <= 0) {
+            qWarning() << "Couldn't write" << filePath;
+            ::close(fd);
+
+            return false;
+        }
+
+        written += count;
+    }
+
+    ::close(fd);
+
+    ++m_statistics.files;
+    m_statistics.bytes += size;
+
+    return true;
+}
+
+bool TreeGenerator::generateLevel(const QString &dirPath, int depth, int fanout, int filesPerDir)
+{
+    for (int i = 0; i < filesPerDir; ++i) {
+        if (!createFile(dirPath + QDir::separator() + fileName(i), fileSize()))
+            return false;
+    }
+
+    if (depth <= 0)
+        return true;
+
+    for (int i = 0; i < fanout; ++i) {
+        const QString &subDirPath = dirPath + QDir::separator() + QString("dir_%1").arg(i);
+
+        if (!QDir().mkdir(subDirPath))
+            return false;
+
+        ++m_statistics.directories;
+
+        if (!generateLevel(subDirPath, depth - 1, fanout, filesPerDir))
+            return false;
+    }
+
+    return true;
+}
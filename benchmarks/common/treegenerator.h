@@ -0,0 +1,58 @@
+#ifndef TREEGENERATOR_H
+#define TREEGENERATOR_H
+
+#include <QString>
+
+/// Creates synthetic directories for the benchmarks. The same seed always
+/// gives the same names and sizes, so runs on different machines compare.
+class TreeGenerator
+{
+public:
+    enum NameStyle {
+        AsciiNames,
+        CjkNames,
+        MixedNames
+    };
+
+    enum SizeStyle {
+        EmptyFiles,
+        MixedSizes
+    };
+
+    struct Statistics
+    {
+        qint64 files = 0;
+        qint64 directories = 0;
+        qint64 bytes = 0;
+    };
+
+    explicit TreeGenerator(quint32 seed = 1);
+
+    void setNameStyle(NameStyle style);
+    void setSizeStyle(SizeStyle style);
+    /// mixed sizes stop growing files once this many bytes were written
+    void setMaxBytes(qint64 bytes);
+
+    /// \a count files directly in \a dirPath
+    bool generateFlat(const QString &dirPath, int count);
+    /// \a depth levels of \a fanout directories, each with \a filesPerDir files
+    bool generateTree(const QString &dirPath, int depth, int fanout, int filesPerDir);
+
+    Statistics statistics() const;
+
+    QString fileName(int index);
+
+private:
+    quint32 random();
+    qint64 fileSize();
+    bool createFile(const QString &filePath, qint64 size);
+    bool generateLevel(const QString &dirPath, int depth, int fanout, int filesPerDir);
+
+    quint32 m_seed;
+    NameStyle m_nameStyle = MixedNames;
+    SizeStyle m_sizeStyle = EmptyFiles;
+    qint64 m_maxBytes = Q_INT64_C(256) << 20;
+    Statistics m_statistics;
+};
+
+#endif // TREEGENERATOR_H
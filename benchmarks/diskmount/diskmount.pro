@@ -0,0 +1,10 @@
+QT += core dbus
+QT -= gui
+
+TARGET = mock_diskmount
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+SOURCES += \
+    mock_diskmount.cpp
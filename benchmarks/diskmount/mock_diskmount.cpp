@@ -0,0 +1,332 @@
+/// A stand-in for com.deepin.daemon.DiskMount that replays device storms.
+///
+/// Run it on a private session bus together with the file manager, e.g.
+///     dbus-run-session -- sh -c "mock_diskmount --storm 16 & dde-file-manager"
+/// and read the JSON summary it prints once the storm has settled: how many
+/// Changed signals were sent, how many queries they caused and how long after
+/// the last signal the last query arrived.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QFile>
+#include <QMap>
+#include <QDebug>
+
+#include <cstdio>
+
+#define EventTypeVolumeAdded 1
+#define EventTypeVolumeRemoved 2
+#define EventTypeMountAdded 3
+#define EventTypeMountRemoved 4
+
+/// marshalled exactly like DiskInfo of dbusinterface/dbustype.h, (ssssssbbtt)
+struct MockDisk
+{
+    QString id;
+    QString name;
+    QString type;
+    QString path;
+    QString mountPoint;
+    QString icon;
+    bool canUnmount = false;
+    bool canEject = true;
+    qulonglong used = 0;
+    qulonglong total = 0;
+};
+
+typedef QList<MockDisk> MockDiskList;
+
+Q_DECLARE_METATYPE(MockDisk)
+Q_DECLARE_METATYPE(MockDiskList)
+
+QDBusArgument &operator<<(QDBusArgument &argument, const MockDisk &disk)
+{
+    argument.beginStructure();
+    argument << disk.id << disk.name;
+    argument << disk.type << disk.path;
+    argument << disk.mountPoint << disk.icon;
+    argument << disk.canUnmount << disk.canEject;
+    argument << disk.used << disk.total;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, MockDisk &disk)
+{
+    argument.beginStructure();
+    argument >> disk.id >> disk.name;
+    argument >> disk.type >> disk.path;
+    argument >> disk.mountPoint >> disk.icon;
+    argument >> disk.canUnmount >> disk.canEject;
+    argument >> disk.used >> disk.total;
+    argument.endStructure();
+    return argument;
+}
+
+struct ReplayEvent
+{
+    int msecs;
+    QString action;
+    QString id;
+};
+
+class MockDiskMount : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.deepin.daemon.DiskMount")
+
+public:
+    explicit MockDiskMount(int replyDelay, QObject *parent = 0)
+        : QObject(parent)
+        , m_replyDelay(replyDelay)
+    {
+        m_clock.start();
+    }
+
+    void replay(const QList<ReplayEvent> &events, int settle)
+    {
+        int last = 0;
+
+        for (const ReplayEvent &event : events) {
+            QTimer::singleShot(event.msecs, this, [this, event] {
+                apply(event);
+            });
+
+            last = qMax(last, event.msecs);
+        }
+
+        QTimer::singleShot(last + settle, this, &MockDiskMount::finish);
+    }
+
+public slots:
+    MockDiskList ListDisk()
+    {
+        ++m_listDiskCount;
+        m_lastRequest = m_clock.elapsed();
+
+        return delayReply(QVariant::fromValue(m_disks.values())).value<MockDiskList>();
+    }
+
+    MockDisk QueryDisk(const QString &id)
+    {
+        ++m_queryDiskCount;
+        m_lastRequest = m_clock.elapsed();
+
+        if (!m_disks.contains(id)) {
+            sendErrorReply(QDBusError::InvalidArgs, "no such disk: " + id);
+
+            return MockDisk();
+        }
+
+        return delayReply(QVariant::fromValue(m_disks.value(id))).value<MockDisk>();
+    }
+
+    void Mount(const QString &id)
+    {
+        apply({0, "mount", id});
+    }
+
+    void Unmount(const QString &id)
+    {
+        apply({0, "unmount", id});
+    }
+
+    void Eject(const QString &id)
+    {
+        apply({0, "remove", id});
+    }
+
+signals:
+    void Changed(int in0, const QString &in1);
+    void Error(const QString &in0, const QString &in1);
+
+private:
+    QVariant delayReply(const QVariant &value)
+    {
+        if (m_replyDelay <= 0)
+            return value;
+
+        /// simulates a slow drive, the caller sees the reply m_replyDelay later
+        setDelayedReply(true);
+
+        const QDBusMessage &reply = message().createReply(value);
+        QDBusConnection bus = connection();
+
+        QTimer::singleShot(m_replyDelay, this, [bus, reply] {
+            bus.send(reply);
+        });
+
+        return value;
+    }
+
+    void apply(const ReplayEvent &event)
+    {
+        int type = 0;
+
+        if (event.action == "add") {
+            MockDisk disk;
+
+            disk.id = event.id;
+            disk.name = event.id;
+            disk.type = "removable";
+            disk.path = "/dev/" + event.id;
+            disk.icon = "drive-removable-media";
+            disk.total = 8ULL << 30;
+
+            m_disks.insert(event.id, disk);
+            type = EventTypeVolumeAdded;
+        } else if (event.action == "remove") {
+            m_disks.remove(event.id);
+            type = EventTypeVolumeRemoved;
+        } else if (event.action == "mount" && m_disks.contains(event.id)) {
+            MockDisk &disk = m_disks[event.id];
+
+            disk.mountPoint = "/media/mock/" + event.id;
+            disk.canUnmount = true;
+            type = EventTypeMountAdded;
+        } else if (event.action == "unmount" && m_disks.contains(event.id)) {
+            MockDisk &disk = m_disks[event.id];
+
+            disk.mountPoint.clear();
+            disk.canUnmount = false;
+            type = EventTypeMountRemoved;
+        } else {
+            return;
+        }
+
+        if (m_changedCount == 0)
+            m_firstChanged = m_clock.elapsed();
+
+        ++m_changedCount;
+        m_lastChanged = m_clock.elapsed();
+
+        emit Changed(type, event.id);
+    }
+
+    void finish()
+    {
+        QJsonObject object;
+
+        object["changed"] = m_changedCount;
+        object["queryDisk"] = m_queryDiskCount;
+        object["listDisk"] = m_listDiskCount;
+        object["firstChangedMs"] = m_firstChanged;
+        object["lastChangedMs"] = m_lastChanged;
+        object["lastRequestMs"] = m_lastRequest;
+        object["settleMs"] = m_lastRequest >= 0 ? m_lastRequest - m_lastChanged : -1;
+
+        std::fputs(QJsonDocument(object).toJson().constData(), stdout);
+        std::fflush(stdout);
+
+        qApp->quit();
+    }
+
+    QMap<QString, MockDisk> m_disks;
+    QElapsedTimer m_clock;
+    int m_replyDelay;
+
+    int m_changedCount = 0;
+    int m_queryDiskCount = 0;
+    int m_listDiskCount = 0;
+    qint64 m_firstChanged = -1;
+    qint64 m_lastChanged = -1;
+    qint64 m_lastRequest = -1;
+};
+
+/// "<msecs> <add|remove|mount|unmount> <id>" per line, '#' starts a comment
+static QList<ReplayEvent> readReplayFile(const QString &filePath)
+{
+    QList<ReplayEvent> events;
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Couldn't open replay file" << filePath;
+
+        return events;
+    }
+
+    while (!file.atEnd()) {
+        const QString &line = QString::fromUtf8(file.readLine()).section('#', 0, 0).simplified();
+        const QStringList &fields = line.split(' ', QString::SkipEmptyParts);
+
+        if (fields.size() != 3)
+            continue;
+
+        events.append({fields.at(0).toInt(), fields.at(1), fields.at(2)});
+    }
+
+    return events;
+}
+
+/// a hub with \a count partitions: plugged in, auto mounted, then pulled out
+static QList<ReplayEvent> stormEvents(int count)
+{
+    QList<ReplayEvent> events;
+    int msecs = 0;
+
+    for (const QString &action : QStringList {"add", "mount", "remove"}) {
+        for (int i = 0; i < count; ++i) {
+            events.append({msecs, action, QString("sdz%1").arg(i + 1)});
+            msecs += 5;
+        }
+
+        msecs += 1000;
+    }
+
+    return events;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    qDBusRegisterMetaType<MockDisk>();
+    qDBusRegisterMetaType<MockDiskList>();
+
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Mock com.deepin.daemon.DiskMount service");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"storm", "Replay a storm of <count> partitions.", "count", "8"},
+        {"replay", "Replay the events of <file>.", "file"},
+        {"delay", "Delay every reply by <msecs>.", "msecs", "0"},
+        {"settle", "Wait <msecs> after the last event.", "msecs", "2000"},
+        {"start", "Wait <msecs> before the first event.", "msecs", "3000"},
+    });
+    parser.process(app);
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    MockDiskMount service(parser.value("delay").toInt());
+
+    if (!bus.registerService("com.deepin.daemon.DiskMount")
+            || !bus.registerObject("/com/deepin/daemon/DiskMount", &service,
+                                   QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals)) {
+        qWarning() << "Couldn't register the mock service:" << bus.lastError().message();
+
+        return 1;
+    }
+
+    QList<ReplayEvent> events = parser.isSet("replay") ? readReplayFile(parser.value("replay"))
+                                                       : stormEvents(parser.value("storm").toInt());
+    int start = parser.value("start").toInt();
+
+    for (ReplayEvent &event : events) {
+        event.msecs += start;
+    }
+
+    service.replay(events, parser.value("settle").toInt());
+
+    return app.exec();
+}
+
+#include "mock_diskmount.moc"
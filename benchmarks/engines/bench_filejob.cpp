@@ -0,0 +1,266 @@
+#include "enginebenchmarks.h"
+
+#include "filemanager/controllers/filejob.h"
+#include "filemanager/shutil/uringbatch.h"
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <sys/stat.h>
+
+#define SPARSE_FILE_SIZE (Q_INT64_C(1) << 30)
+#define SPARSE_EXTENT_SIZE (1 << 20)
+#define SPARSE_EXTENT_DISTANCE (64 << 20)
+
+static void treeStatistics(const QString &dirPath, qint64 *files, qint64 *bytes)
+{
+    QDirIterator iterator(dirPath, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+
+    *files = 0;
+    *bytes = 0;
+
+    while (iterator.hasNext()) {
+        iterator.next();
+
+        ++*files;
+        *bytes += iterator.fileInfo().size();
+    }
+}
+
+/// 1 GiB with 1 MiB of data every 64 MiB, the copy should stay as small
+static void benchSparseCopy(const BenchmarkData &data, BenchmarkReportList &reports)
+{
+    BenchmarkReport report("filejob.copy.sparse");
+    const QString &sparsePath = data.workPath + "/sparse.img";
+    QFile file(sparsePath);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        report.setFailed("couldn't create " + sparsePath);
+        reports << report;
+
+        return;
+    }
+
+    const QByteArray extent(SPARSE_EXTENT_SIZE, 'x');
+
+    for (qint64 offset = 0; offset < SPARSE_FILE_SIZE; offset += SPARSE_EXTENT_DISTANCE) {
+        file.seek(offset);
+        file.write(extent);
+    }
+
+    file.resize(SPARSE_FILE_SIZE);
+    file.close();
+
+    for (int i = 0; i < data.repeat; ++i) {
+        const QString &copyDirPath = QString("%1/sparse%2").arg(data.workPath).arg(i);
+
+        if (!QDir().mkpath(copyDirPath)) {
+            report.setFailed("no work directory");
+
+            break;
+        }
+
+        FileJob copyJob("copy");
+        Stopwatch watch;
+
+        report.start();
+        copyJob.doCopy(DUrlList() << DUrl::fromLocalFile(sparsePath), DUrl::fromLocalFile(copyDirPath).toString());
+        report.stop();
+        report.addSample(watch.lap());
+        report.addItems(1);
+        report.addBytes(SPARSE_FILE_SIZE / SPARSE_EXTENT_DISTANCE * SPARSE_EXTENT_SIZE);
+
+        struct stat st;
+        const QByteArray &copiedPath = QFile::encodeName(copyDirPath + "/sparse.img");
+
+        if (::stat(copiedPath.constData(), &st) != 0 || st.st_size != SPARSE_FILE_SIZE) {
+            report.setFailed("wrong size of " + copyDirPath + "/sparse.img");
+
+            break;
+        }
+
+        report.setValue("allocatedBytes", qint64(st.st_blocks) * 512);
+        QFile::remove(QFile::decodeName(copiedPath));
+    }
+
+    QFile::remove(sparsePath);
+    reports << report;
+}
+
+/// the same copy as filejob.copy, checked against the source afterwards
+static void benchVerifiedCopy(const BenchmarkData &data, qint64 files, qint64 bytes, BenchmarkReportList &reports)
+{
+    BenchmarkReport report("filejob.copy.verify");
+
+    FileJob::Verify_Copy = true;
+
+    for (int i = 0; i < data.repeat; ++i) {
+        const QString &copyDirPath = QString("%1/verify%2").arg(data.workPath).arg(i);
+
+        if (!QDir().mkpath(copyDirPath)) {
+            report.setFailed("no work directory");
+
+            break;
+        }
+
+        FileJob copyJob("copy");
+        Stopwatch watch;
+        int failures = 0;
+
+        QObject::connect(&copyJob, &FileJob::error, [&failures] {
+            ++failures;
+        });
+
+        report.start();
+        copyJob.doCopy(DUrlList() << DUrl::fromLocalFile(data.treePath), DUrl::fromLocalFile(copyDirPath).toString());
+        report.stop();
+        report.addSample(watch.lap());
+        report.addItems(files);
+        report.addBytes(bytes);
+
+        QDir(copyDirPath).removeRecursively();
+
+        if (failures > 0) {
+            report.setFailed(QString("%1 files don't match their source").arg(failures));
+
+            break;
+        }
+    }
+
+    FileJob::Verify_Copy = false;
+    reports << report;
+}
+
+/// filejob.copy and filejob.delete again, with the small files batched
+static void benchUringJobs(const BenchmarkData &data, qint64 files, qint64 bytes, BenchmarkReportList &reports)
+{
+    BenchmarkReport copy("filejob.copy.uring");
+    BenchmarkReport remove("filejob.delete.uring");
+    const QString &treeName = QFileInfo(data.treePath).fileName();
+
+    if (!UringBatch().isValid()) {
+        copy.setFailed("io_uring isn't available");
+        remove.setFailed("io_uring isn't available");
+        reports << copy << remove;
+
+        return;
+    }
+
+    FileJob::Use_IO_Uring = true;
+
+    for (int i = 0; i < data.repeat; ++i) {
+        const QString &copyDirPath = QString("%1/uring%2").arg(data.workPath).arg(i);
+
+        if (!QDir().mkpath(copyDirPath)) {
+            copy.setFailed("no work directory");
+
+            break;
+        }
+
+        FileJob copyJob("copy");
+        Stopwatch watch;
+
+        copy.start();
+        copyJob.doCopy(DUrlList() << DUrl::fromLocalFile(data.treePath), DUrl::fromLocalFile(copyDirPath).toString());
+        copy.stop();
+        copy.addSample(watch.lap());
+        copy.addItems(files);
+        copy.addBytes(bytes);
+
+        const QString &copiedPath = copyDirPath + "/" + treeName;
+        qint64 copiedFiles;
+        qint64 copiedBytes;
+
+        treeStatistics(copiedPath, &copiedFiles, &copiedBytes);
+
+        if (copiedFiles != files || copiedBytes != bytes) {
+            copy.setFailed(QString("copied %1 files of %2").arg(copiedFiles).arg(files));
+
+            break;
+        }
+
+        FileJob deleteJob("delete");
+
+        watch.lap();
+        remove.start();
+        deleteJob.doDelete(DUrlList() << DUrl::fromLocalFile(copiedPath));
+        remove.stop();
+        remove.addSample(watch.lap());
+        remove.addItems(files);
+
+        if (QFileInfo::exists(copiedPath))
+            remove.setFailed("left " + copiedPath);
+    }
+
+    FileJob::Use_IO_Uring = false;
+    reports << copy << remove;
+}
+
+void benchFileJob(const BenchmarkData &data, BenchmarkReportList &reports)
+{
+    BenchmarkReport copy("filejob.copy");
+    BenchmarkReport move("filejob.move");
+    BenchmarkReport remove("filejob.delete");
+    const QString &treeName = QFileInfo(data.treePath).fileName();
+    qint64 files;
+    qint64 bytes;
+
+    treeStatistics(data.treePath, &files, &bytes);
+
+    for (int i = 0; i < data.repeat; ++i) {
+        const QString &copyDirPath = QString("%1/copy%2").arg(data.workPath).arg(i);
+        const QString &moveDirPath = QString("%1/move%2").arg(data.workPath).arg(i);
+
+        if (!QDir().mkpath(copyDirPath) || !QDir().mkpath(moveDirPath)) {
+            copy.setFailed("no work directory");
+
+            break;
+        }
+
+        /// a fresh job for every step, like the file manager does
+        FileJob copyJob("copy");
+        Stopwatch watch;
+
+        copy.start();
+        copyJob.doCopy(DUrlList() << DUrl::fromLocalFile(data.treePath), DUrl::fromLocalFile(copyDirPath).toString());
+        copy.stop();
+        copy.addSample(watch.lap());
+        copy.addItems(files);
+        copy.addBytes(bytes);
+
+        const QString &copiedPath = copyDirPath + "/" + treeName;
+        FileJob moveJob("move");
+
+        move.start();
+        moveJob.doMove(DUrlList() << DUrl::fromLocalFile(copiedPath), DUrl::fromLocalFile(moveDirPath).toString());
+        move.stop();
+        move.addSample(watch.lap());
+        move.addItems(files);
+
+        const QString &movedPath = moveDirPath + "/" + treeName;
+        FileJob deleteJob("delete");
+
+        if (!QFileInfo::exists(movedPath)) {
+            move.setFailed("nothing moved to " + movedPath);
+
+            break;
+        }
+
+        remove.start();
+        deleteJob.doDelete(DUrlList() << DUrl::fromLocalFile(movedPath));
+        remove.stop();
+        remove.addSample(watch.lap());
+        remove.addItems(files);
+
+        if (QFileInfo::exists(movedPath))
+            remove.setFailed("left " + movedPath);
+    }
+
+    reports << copy << move << remove;
+
+    benchUringJobs(data, files, bytes, reports);
+    benchVerifiedCopy(data, files, bytes, reports);
+    benchSparseCopy(data, reports);
+}
@@ -0,0 +1,88 @@
+#include "enginebenchmarks.h"
+#include "treegenerator.h"
+
+#include "filemonitor/filemonitorwoker.h"
+
+#include <QHash>
+#include <QFile>
+#include <QDir>
+
+#define MONITOR_FILE_COUNT 20000
+#define MONITOR_BURST_SIZE 100
+
+void benchFileMonitor(const BenchmarkData &data, BenchmarkReportList &reports)
+{
+    BenchmarkReport create("monitor.create");
+    BenchmarkReport remove("monitor.delete");
+
+    for (int i = 0; i < data.repeat; ++i) {
+        const QString &dirPath = QString("%1/monitor%2").arg(data.workPath).arg(i);
+
+        if (!QDir().mkpath(dirPath)) {
+            create.setFailed("no work directory");
+
+            break;
+        }
+
+        FileMonitorWoker worker;
+        TreeGenerator generator(i + 1);
+        QHash<QString, qint64> pending;
+        Stopwatch watch;
+
+        /// from the syscall to the signal, which includes the wait for the event loop
+        QObject::connect(&worker, &FileMonitorWoker::fileCreated, [&] (int, const QString &path) {
+            if (pending.contains(path))
+                create.addSample(watch.elapsed() - pending.take(path));
+        });
+        QObject::connect(&worker, &FileMonitorWoker::fileDeleted, [&] (int, const QString &path) {
+            if (pending.contains(path))
+                remove.addSample(watch.elapsed() - pending.take(path));
+        });
+
+        worker.addPath(dirPath);
+
+        QStringList filePaths;
+
+        for (int j = 0; j < MONITOR_FILE_COUNT; ++j) {
+            filePaths << dirPath + "/" + generator.fileName(j);
+        }
+
+        bool ok = true;
+
+        for (int step = 0; step < 2 && ok; ++step) {
+            BenchmarkReport &report = step == 0 ? create : remove;
+
+            report.start();
+
+            for (int j = 0; j < filePaths.count() && ok; j += MONITOR_BURST_SIZE) {
+                for (int k = j; k < qMin(j + MONITOR_BURST_SIZE, filePaths.count()); ++k) {
+                    QFile file(filePaths.at(k));
+
+                    pending.insert(filePaths.at(k), watch.elapsed());
+
+                    if (step == 0)
+                        file.open(QIODevice::WriteOnly);
+                    else
+                        file.remove();
+                }
+
+                ok = waitFor([&pending] {
+                    return pending.isEmpty();
+                }, data.timeout);
+            }
+
+            report.stop();
+            report.addItems(filePaths.count() - pending.count());
+            report.setValue("lost", pending.count());
+
+            if (!ok)
+                report.setFailed("timeout");
+
+            pending.clear();
+        }
+
+        QDir(dirPath).removeRecursively();
+    }
+
+    reports << create << remove;
+}
@@ -0,0 +1,72 @@
+#include "enginebenchmarks.h"
+
+#include "filemanager/models/dfilesystemmodel.h"
+
+void benchModel(const BenchmarkData &data, BenchmarkReportList &reports)
+{
+    BenchmarkReport populate("model.populate");
+    QList<BenchmarkReport> sorts;
+    const QList<int> roles {DFileSystemModel::FileDisplayNameRole, DFileSystemModel::FileSizeRole,
+                            DFileSystemModel::FileLastModifiedRole, DFileSystemModel::FileMimeTypeRole};
+
+    for (int role : roles) {
+        sorts << BenchmarkReport("model.sort." + DFileSystemModel::roleName(role));
+    }
+
+    for (int i = 0; i < data.repeat; ++i) {
+        DFileSystemModel model;
+        const QModelIndex &root = model.setRootUrl(DUrl::fromLocalFile(data.flatPath));
+        Stopwatch watch;
+
+        /// the children arrive in batches, the gaps are what the view waits for
+        QObject::connect(&model, &QAbstractItemModel::rowsInserted, [&populate, &watch] {
+            populate.addSample(watch.lap());
+        });
+
+        populate.start();
+        watch.lap();
+        model.fetchMore(root);
+
+        bool ok = waitFor([&model] {
+            return model.state() == DFileSystemModel::Idle;
+        }, data.timeout);
+
+        populate.stop();
+        populate.addItems(model.rowCount(root));
+
+        if (!ok) {
+            populate.setFailed("timeout");
+
+            break;
+        }
+
+        for (int j = 0; j < roles.count(); ++j) {
+            BenchmarkReport &report = sorts[j];
+            bool sorted = false;
+            auto connection = QObject::connect(&model, &QAbstractItemModel::dataChanged, [&sorted] {
+                sorted = true;
+            });
+
+            Stopwatch sortWatch;
+
+            report.start();
+            model.setSortRole(roles.at(j), i % 2 ? Qt::AscendingOrder : Qt::DescendingOrder);
+            model.sort();
+
+            ok = waitFor([&sorted] {
+                return sorted;
+            }, data.timeout);
+
+            report.stop();
+            report.addItems(model.rowCount(root));
+            report.addSample(sortWatch.elapsed());
+
+            QObject::disconnect(connection);
+
+            if (!ok)
+                report.setFailed("timeout");
+        }
+    }
+
+    reports << populate << sorts;
+}
@@ -0,0 +1,42 @@
+#include "enginebenchmarks.h"
+#include "treegenerator.h"
+
+#include "chinese2pinyin.h"
+
+#define PINYIN_NAME_COUNT 100000
+#define PINYIN_BATCH_SIZE 1000
+
+void benchPinyin(const BenchmarkData &data, BenchmarkReportList &reports)
+{
+    TreeGenerator generator;
+    QStringList names;
+
+    generator.setNameStyle(TreeGenerator::CjkNames);
+
+    for (int i = 0; i < PINYIN_NAME_COUNT; ++i) {
+        names << generator.fileName(i);
+    }
+
+    BenchmarkReport report("pinyin");
+    int length = 0;
+
+    for (int i = 0; i < data.repeat; ++i) {
+        Stopwatch watch;
+
+        report.start();
+
+        /// single conversions are too short to time one by one
+        for (int j = 0; j < names.count(); ++j) {
+            length += Pinyin::Chinese2Pinyin(names.at(j)).length();
+
+            if ((j + 1) % PINYIN_BATCH_SIZE == 0)
+                report.addSample(watch.lap() / PINYIN_BATCH_SIZE);
+        }
+
+        report.stop();
+        report.addItems(names.count());
+    }
+
+    report.setValue("pinyinLength", length / data.repeat);
+    reports << report;
+}
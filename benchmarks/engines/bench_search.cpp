@@ -0,0 +1,115 @@
+#include "enginebenchmarks.h"
+#include "treegenerator.h"
+
+#include "filemanager/controllers/fileservices.h"
+#include "filemanager/models/ddiriterator.h"
+#include "filemanager/shutil/filenamematcher.h"
+
+#include <QDir>
+#include <QRegularExpression>
+
+#define MATCH_NAME_COUNT 100000
+#define MATCH_BATCH_SIZE 1000
+
+/// the names as the regular expression used to see them and as dirent bytes
+static void benchMatch(const BenchmarkData &data, const QString &keyword, BenchmarkReportList &reports)
+{
+    TreeGenerator generator;
+    QStringList names;
+    QList<QByteArray> rawNames;
+
+    for (int i = 0; i < MATCH_NAME_COUNT; ++i) {
+        names << generator.fileName(i);
+        rawNames << names.last().toUtf8();
+    }
+
+    BenchmarkReport regexReport("search.match.regex");
+    BenchmarkReport matcherReport("search.match.compiled");
+    const QRegularExpression regular(QRegularExpression::escape(keyword), QRegularExpression::CaseInsensitiveOption);
+    const FileNameMatcher matcher(keyword);
+    int regexHits = 0;
+    int matcherHits = 0;
+
+    for (int i = 0; i < data.repeat; ++i) {
+        Stopwatch watch;
+
+        regexReport.start();
+
+        for (int j = 0; j < names.count(); ++j) {
+            if (names.at(j).indexOf(regular) >= 0)
+                ++regexHits;
+
+            if ((j + 1) % MATCH_BATCH_SIZE == 0)
+                regexReport.addSample(watch.lap() / MATCH_BATCH_SIZE);
+        }
+
+        regexReport.stop();
+        regexReport.addItems(names.count());
+
+        watch.lap();
+        matcherReport.start();
+
+        for (int j = 0; j < rawNames.count(); ++j) {
+            if (matcher.match(rawNames.at(j).constData(), rawNames.at(j).size()))
+                ++matcherHits;
+
+            if ((j + 1) % MATCH_BATCH_SIZE == 0)
+                matcherReport.addSample(watch.lap() / MATCH_BATCH_SIZE);
+        }
+
+        matcherReport.stop();
+        matcherReport.addItems(rawNames.count());
+    }
+
+    regexReport.setValue("keyword", keyword);
+    regexReport.setValue("hits", regexHits / data.repeat);
+    matcherReport.setValue("keyword", keyword);
+    /// more than the regex for pinyin keywords
+    matcherReport.setValue("hits", matcherHits / data.repeat);
+    reports << regexReport << matcherReport;
+}
+
+void benchSearch(const BenchmarkData &data, BenchmarkReportList &reports)
+{
+    /// many hits, a word, a CJK character, its pinyin and no hit at all
+    const QStringList keywords {"1", "photo", QString::fromUtf8("\xe6\x96\x87"), "wen", "zzzz"};
+
+    for (const QString &keyword : keywords) {
+        BenchmarkReport report("search");
+        const DUrl &searchUrl = DUrl::fromSearchFile(DUrl::fromLocalFile(data.flatPath), keyword);
+        qint64 firstResult = -1;
+
+        report.setValue("keyword", keyword);
+
+        for (int i = 0; i < data.repeat; ++i) {
+            const DDirIteratorPointer &iterator = FileServices::instance()->createDirIterator(
+                        searchUrl, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System | QDir::Hidden);
+
+            if (!iterator) {
+                report.setFailed("no iterator");
+
+                break;
+            }
+
+            Stopwatch watch;
+
+            report.start();
+
+            /// the gap between two results is how long the view waits for a row
+            while (iterator->hasNext()) {
+                iterator->next();
+                report.addSample(watch.lap());
+                report.addItems(1);
+
+                if (firstResult < 0)
+                    firstResult = watch.elapsed();
+            }
+
+            report.stop();
+        }
+
+        report.setValue("firstResultMs", firstResult / 1e6);
+        reports << report;
+        benchMatch(data, keyword, reports);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef ENGINEBENCHMARKS_H
+#define ENGINEBENCHMARKS_H
+
+#include "benchmarkreport.h"
+
+#include <QList>
+#include <functional>
+
+struct BenchmarkData
+{
+    /// a flat directory, for listing, sorting and searching
+    QString flatPath;
+    /// a tree with file contents, for the file jobs
+    QString treePath;
+    /// scratch space on the same file system as treePath
+    QString workPath;
+    int repeat = 3;
+    int timeout = 600000;
+};
+
+typedef QList<BenchmarkReport> BenchmarkReportList;
+
+/// runs the event loop until \a condition holds or \a timeout msecs passed
+bool waitFor(const std::function<bool()> &condition, int timeout);
+
+void benchModel(const BenchmarkData &data, BenchmarkReportList &reports);
+void benchSearch(const BenchmarkData &data, BenchmarkReportList &reports);
+void benchFileJob(const BenchmarkData &data, BenchmarkReportList &reports);
+void benchFileMonitor(const BenchmarkData &data, BenchmarkReportList &reports);
+void benchPinyin(const BenchmarkData &data, BenchmarkReportList &reports);
+
+#endif // ENGINEBENCHMARKS_H
@@ -0,0 +1,18 @@
+TARGET = bench_engines
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+include($$PWD/../common/common.pri)
+include($$PWD/../common/app.pri)
+
+HEADERS += \
+    enginebenchmarks.h
+
+SOURCES += \
+    main.cpp \
+    bench_model.cpp \
+    bench_search.cpp \
+    bench_filejob.cpp \
+    bench_filemonitor.cpp \
+    bench_pinyin.cpp
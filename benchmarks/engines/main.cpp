@@ -0,0 +1,191 @@
+/// Drives the file manager engines without a window and reports throughput
+/// and latency percentiles as JSON, e.g.
+///     bench_engines --bench model,search --entries 1000000 --output flat.json
+/// Without --flat/--tree the data is generated into a temporary directory.
+
+#include "enginebenchmarks.h"
+#include "treegenerator.h"
+
+#include "filemanager/app/global.h"
+#include "filemanager/controllers/fileservices.h"
+#include "filemanager/controllers/filecontroller.h"
+#include "filemanager/controllers/searchcontroller.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+#include <cstdio>
+
+bool waitFor(const std::function<bool()> &condition, int timeout)
+{
+    QElapsedTimer timer;
+
+    timer.start();
+
+    while (!condition()) {
+        if (timer.elapsed() > timeout)
+            return false;
+
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    /// headless, the engines only need a QGuiApplication for icons and fonts
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    app.setOrganizationName(QMAKE_ORGANIZATION_NAME);
+    app.setApplicationName("dde-file-manager-benchmark");
+
+    parser.setApplicationDescription("Benchmarks of the dde-file-manager engines");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"bench", "Comma separated: model, search, filejob, monitor, pinyin.", "names",
+         "model,search,filejob,monitor,pinyin"},
+        {"flat", "Use the existing flat directory <path>.", "path"},
+        {"tree", "Use the existing tree <path> for the file jobs.", "path"},
+        {"entries", "Generate a flat directory of <count> files.", "count", "100000"},
+        {"depth", "Generate a tree <levels> deep.", "levels", "4"},
+        {"fanout", "Sub directories per directory of the tree.", "count", "4"},
+        {"files", "Files per directory of the tree.", "count", "32"},
+        {"names", "Generated names: ascii, cjk or mixed.", "style", "mixed"},
+        {"repeat", "Run every benchmark <count> times.", "count", "3"},
+        {"timeout", "Give up a step after <secs>.", "secs", "600"},
+        {"output", "Write the JSON to <file> instead of stdout.", "file"},
+        {"verbose", "Keep the debug output of the engines."},
+    });
+    parser.process(app);
+
+    /// the engines log every file they touch, which would be measured too
+    if (!parser.isSet("verbose"))
+        QLoggingCategory::setFilterRules("*.debug=false");
+
+    FileServices::dRegisterUrlHandler<FileController>(FILE_SCHEME, "");
+    FileServices::dRegisterUrlHandler<SearchController>(SEARCH_SCHEME, "");
+
+    QTemporaryDir tempDir(QDir::tempPath() + "/dde-file-manager-benchmark-XXXXXX");
+    BenchmarkData data;
+    QJsonObject generated;
+
+    data.repeat = qMax(parser.value("repeat").toInt(), 1);
+    data.timeout = parser.value("timeout").toInt() * 1000;
+    data.flatPath = parser.value("flat");
+    data.treePath = parser.value("tree");
+    data.workPath = tempDir.path() + "/work";
+
+    if (!tempDir.isValid() || !QDir().mkpath(data.workPath)) {
+        qWarning() << "Couldn't create a temporary directory in" << QDir::tempPath();
+
+        return 1;
+    }
+
+    TreeGenerator::NameStyle nameStyle = TreeGenerator::MixedNames;
+
+    if (parser.value("names") == "ascii")
+        nameStyle = TreeGenerator::AsciiNames;
+    else if (parser.value("names") == "cjk")
+        nameStyle = TreeGenerator::CjkNames;
+
+    if (data.flatPath.isEmpty()) {
+        TreeGenerator generator;
+        QElapsedTimer timer;
+
+        data.flatPath = tempDir.path() + "/flat";
+        generator.setNameStyle(nameStyle);
+        timer.start();
+
+        if (!generator.generateFlat(data.flatPath, parser.value("entries").toInt()))
+            return 1;
+
+        generated["flatFiles"] = generator.statistics().files;
+        generated["flatMs"] = timer.elapsed();
+    }
+
+    if (data.treePath.isEmpty()) {
+        TreeGenerator generator(2);
+        QElapsedTimer timer;
+
+        data.treePath = tempDir.path() + "/tree";
+        generator.setNameStyle(nameStyle);
+        generator.setSizeStyle(TreeGenerator::MixedSizes);
+        timer.start();
+
+        if (!generator.generateTree(data.treePath, parser.value("depth").toInt(),
+                                    parser.value("fanout").toInt(), parser.value("files").toInt())) {
+            return 1;
+        }
+
+        generated["treeFiles"] = generator.statistics().files;
+        generated["treeBytes"] = generator.statistics().bytes;
+        generated["treeMs"] = timer.elapsed();
+    }
+
+    const QStringList &benchmarks = parser.value("bench").split(',', QString::SkipEmptyParts);
+    BenchmarkReportList reports;
+
+    if (benchmarks.contains("model"))
+        benchModel(data, reports);
+
+    if (benchmarks.contains("search"))
+        benchSearch(data, reports);
+
+    if (benchmarks.contains("filejob"))
+        benchFileJob(data, reports);
+
+    if (benchmarks.contains("monitor"))
+        benchFileMonitor(data, reports);
+
+    if (benchmarks.contains("pinyin"))
+        benchPinyin(data, reports);
+
+    QJsonArray results;
+    bool failed = false;
+
+    for (const BenchmarkReport &report : reports) {
+        results.append(report.toJson());
+        failed = failed || report.isFailed();
+    }
+
+    QJsonObject object;
+
+    object["qtVersion"] = QString(qVersion());
+    object["flat"] = data.flatPath;
+    object["tree"] = data.treePath;
+    object["repeat"] = data.repeat;
+    object["benchmarks"] = results;
+
+    if (!generated.isEmpty())
+        object["generated"] = generated;
+
+    const QByteArray &json = QJsonDocument(object).toJson();
+
+    if (parser.isSet("output")) {
+        QFile file(parser.value("output"));
+
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+            qWarning() << "Couldn't write" << file.fileName();
+
+            return 1;
+        }
+    } else {
+        std::fputs(json.constData(), stdout);
+    }
+
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,12 @@
+QT += core
+QT -= gui
+
+TARGET = bench_gendir
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+include($$PWD/../common/common.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,78 @@
+/// Creates the synthetic directories the engine benchmarks run on, e.g.
+///     bench_gendir --flat 1000000 --names cjk /tmp/flat
+///     bench_gendir --depth 6 --fanout 4 --files 32 --sizes mixed /tmp/deep
+/// and prints what was created as JSON.
+
+#include "treegenerator.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Synthetic directory generator for the benchmarks");
+    parser.addHelpOption();
+    parser.addPositionalArgument("directory", "The directory to create.");
+    parser.addOptions({
+        {"flat", "Create <count> files directly in the directory.", "count"},
+        {"depth", "Create a tree <levels> deep.", "levels", "0"},
+        {"fanout", "Sub directories per directory of the tree.", "count", "4"},
+        {"files", "Files per directory of the tree.", "count", "16"},
+        {"names", "File names: ascii, cjk or mixed.", "style", "mixed"},
+        {"sizes", "File sizes: empty or mixed.", "style", "empty"},
+        {"max-bytes", "Stop filling files after <MiB> in total.", "MiB", "256"},
+        {"seed", "Seed of the names and sizes.", "seed", "1"},
+    });
+    parser.process(app);
+
+    if (parser.positionalArguments().count() != 1)
+        parser.showHelp(1);
+
+    const QString &dirPath = parser.positionalArguments().first();
+    TreeGenerator generator(parser.value("seed").toUInt());
+    const QString &names = parser.value("names");
+
+    if (names == "ascii")
+        generator.setNameStyle(TreeGenerator::AsciiNames);
+    else if (names == "cjk")
+        generator.setNameStyle(TreeGenerator::CjkNames);
+
+    if (parser.value("sizes") == "mixed")
+        generator.setSizeStyle(TreeGenerator::MixedSizes);
+
+    generator.setMaxBytes(parser.value("max-bytes").toLongLong() << 20);
+
+    QElapsedTimer timer;
+    bool ok;
+
+    timer.start();
+
+    if (parser.isSet("flat")) {
+        ok = generator.generateFlat(dirPath, parser.value("flat").toInt());
+    } else {
+        ok = generator.generateTree(dirPath, parser.value("depth").toInt(),
+                                    parser.value("fanout").toInt(), parser.value("files").toInt());
+    }
+
+    const TreeGenerator::Statistics &statistics = generator.statistics();
+    QJsonObject object;
+
+    object["directory"] = dirPath;
+    object["files"] = statistics.files;
+    object["directories"] = statistics.directories;
+    object["bytes"] = statistics.bytes;
+    object["elapsedMs"] = timer.elapsed();
+    object["ok"] = ok;
+
+    std::fputs(QJsonDocument(object).toJson().constData(), stdout);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "chinese2pinyin.h"
+
+#include <QtTest>
+#include <QVector>
+
+class BenchPinyin : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void convert_data();
+    void convert();
+
+    void convertToBuffer_data();
+    void convertToBuffer();
+
+private:
+    QStringList m_asciiNames;
+    QStringList m_hanziNames;
+    QStringList m_mixedNames;
+};
+
+static QStringList generateNames(int count, ushort first, ushort last, bool withAscii)
+{
+    QStringList names;
+    uint seed = 1;
+
+    names.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        QString name;
+
+        for (int j = 0; j < 12; ++j) {
+            seed = seed * 1103515245 + 12345;
+
+            if (withAscii && j % 3 == 0)
+                name.append(QChar('a' + (seed >> 16) % 26));
+            else
+                name.append(QChar(first + (seed >> 16) % (last - first)));
+        }
+
+        names << name + QStringLiteral(".txt");
+    }
+
+    return names;
+}
+
+void BenchPinyin::initTestCase()
+{
+    m_asciiNames = generateNames(10000, 'a', 'z', false);
+    m_hanziNames = generateNames(10000, 0x4e00, 0x9fa5, false);
+    m_mixedNames = generateNames(10000, 0x4e00, 0x9fa5, true);
+
+    QCOMPARE(Pinyin::Chinese2Pinyin(QStringLiteral("readme")), QStringLiteral("readme"));
+    QCOMPARE(Pinyin::Chinese2Pinyin(QString::fromUtf8("中文a")), QStringLiteral("zhong1wen2a"));
+}
+
+void BenchPinyin::convert_data()
+{
+    QTest::addColumn<QStringList>("names");
+
+    QTest::newRow("ascii") << m_asciiNames;
+    QTest::newRow("hanzi") << m_hanziNames;
+    QTest::newRow("mixed") << m_mixedNames;
+}
+
+void BenchPinyin::convert()
+{
+    QFETCH(QStringList, names);
+
+    QBENCHMARK {
+        for (const QString &name : names)
+            Pinyin::Chinese2Pinyin(name);
+    }
+}
+
+void BenchPinyin::convertToBuffer_data()
+{
+    convert_data();
+}
+
+void BenchPinyin::convertToBuffer()
+{
+    QFETCH(QStringList, names);
+
+    QVector<QChar> buffer(Pinyin::MaxPinyinLength(64));
+
+    QBENCHMARK {
+        for (const QString &name : names)
+            Pinyin::Chinese2Pinyin(name.constData(), name.size(), buffer.data(), buffer.size());
+    }
+}
+
+QTEST_APPLESS_MAIN(BenchPinyin)
+
+#include "bench_pinyin.moc"
@@ -0,0 +1,12 @@
+QT += core testlib
+QT -= gui
+
+TARGET = bench_pinyin
+TEMPLATE = app
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+include($$PWD/../../chinese2pinyin/chinese2pinyin.pri)
+
+SOURCES += \
+    bench_pinyin.cpp
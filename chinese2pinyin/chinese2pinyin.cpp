@@ -4,60 +4,78 @@
 
 #include "chinese2pinyin.h"
 
-#include <QHash>
-#include <QTextStream>
-#include <QFile>
+#include "pinyin_table.h"
 
-namespace Pinyin {
+#include <algorithm>
 
-static QHash<uint, QString> dict = {};
+namespace Pinyin {
 
-const char kDictFile[] = ":/misc/pinyin.dict";
+static_assert(sizeof(kSyllableIndex) / sizeof(kSyllableIndex[0]) == kTableLast - kTableFirst + 1,
+              "pinyin table does not cover its code point range");
 
-void InitDict() {
-    if (!dict.isEmpty()) {
-        return;
+static inline const char* Lookup(ushort code) {
+    if (code < kTableFirst || code > kTableLast) {
+        return nullptr;
     }
 
-    dict.reserve(25333);
+    const ushort index = kSyllableIndex[code - kTableFirst];
 
-    QFile file(kDictFile);
+    return index ? kSyllables[index] : nullptr;
+}
 
-    if (!file.open(QIODevice::ReadOnly))
-        return;
+int MaxPinyinLength(int length) {
+    return length * kSyllableMaxLength;
+}
 
-    QByteArray content = file.readAll();
+int Chinese2Pinyin(const QChar* words, int length, QChar* buffer, int buffer_size) {
+    int size = 0;
 
-    file.close();
+    for (int i = 0; i < length; ++i) {
+        const char* syllable = Lookup(words[i].unicode());
 
-    QTextStream stream(&content, QIODevice::ReadOnly);
+        if (!syllable) {
+            if (size < buffer_size) {
+                buffer[size] = words[i];
+            }
 
-    while (!stream.atEnd()) {
-        const QString line = stream.readLine();
-        const QStringList items = line.split(QChar(':'));
+            ++size;
+            continue;
+        }
 
-        if (items.size() == 2) {
-            dict.insert(items[0].toInt(nullptr, 16), items[1]);
+        for (; *syllable; ++syllable, ++size) {
+            if (size < buffer_size) {
+                buffer[size] = QLatin1Char(*syllable);
+            }
         }
     }
+
+    return size;
 }
 
 QString Chinese2Pinyin(const QString& words) {
-    InitDict();
-
-    QString result;
+    const QChar* data = words.constData();
+    const int length = words.length();
+    int first = 0;
 
-    for (int i = 0; i < words.length(); ++i) {
-        const uint key = words.at(i).unicode();
-        auto find_result = dict.find(key);
+    // Names without any Hanzi are the common case, share them as they are
+    while (first < length && !Lookup(data[first].unicode())) {
+        ++first;
+    }
 
-        if (find_result != dict.end()) {
-            result.append(find_result.value());
-        } else {
-            result.append(words.at(i));
-        }
+    if (first == length) {
+        return words;
     }
 
+    QString result(first + MaxPinyinLength(length - first), Qt::Uninitialized);
+    QChar* buffer = result.data();
+
+    std::copy(data, data + first, buffer);
+
+    const int size = Chinese2Pinyin(data + first, length - first,
+                                    buffer + first, result.size() - first);
+
+    result.resize(first + size);
+
     return result;
 }
 
@@ -9,6 +9,14 @@
 
 namespace Pinyin {
 QString Chinese2Pinyin(const QString& words);
+
+// Converts |length| characters of |words| into |buffer| without allocating.
+// At most |buffer_size| characters are written, the returned value is the
+// length of the whole conversion, so a larger buffer can be retried with.
+int Chinese2Pinyin(const QChar* words, int length, QChar* buffer, int buffer_size);
+
+// Upper bound of the converted length of |length| characters.
+int MaxPinyinLength(int length);
 };
 
 #endif  // SERVICE_BACKEND_CHINESE2PINYIN_H_
@@ -4,7 +4,16 @@ HEADERS += \
 SOURCES += \
     $$PWD/chinese2pinyin.cpp
 
-RESOURCES += \
-    $$PWD/data.qrc
+# The dictionary is compiled into a constant table instead of being parsed at runtime
+PINYIN_DICT = $$PWD/pinyin.dict
 
-INCLUDEPATH += $$PWD
+pinyin_table.input = PINYIN_DICT
+pinyin_table.output = $$OUT_PWD/pinyin_table.h
+pinyin_table.commands = awk -f $$PWD/pinyin_table.awk ${QMAKE_FILE_IN} > ${QMAKE_FILE_OUT}
+pinyin_table.depends = $$PWD/pinyin_table.awk
+pinyin_table.variable_out = GENERATED_FILES
+pinyin_table.CONFIG += no_link target_predeps
+
+QMAKE_EXTRA_COMPILERS += pinyin_table
+
+INCLUDEPATH += $$PWD $$OUT_PWD
@@ -0,0 +1,99 @@
+# Generates pinyin_table.h from pinyin.dict at build time.
+#
+# Each "0xXXXX:syllable" line becomes an entry of a dense index covering the
+# first..last dictionary code points, so a lookup is a single array access.
+# Syllables are stored once, as NUL padded ASCII in fixed size slots.
+
+function hex(s,    i, v) {
+    v = 0
+    s = tolower(s)
+    sub(/^0x/, "", s)
+
+    for (i = 1; i <= length(s); i++)
+        v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+
+    return v
+}
+
+BEGIN {
+    FS = ":"
+    count = 0
+    first = -1
+    last = -1
+    maxLength = 0
+}
+
+{
+    sub(/\r$/, "")
+}
+
+NF == 2 {
+    code = hex($1)
+    syllable = $2
+
+    if (length(syllable) > 7) {
+        print "pinyin.dict: syllable too long: " syllable > "/dev/stderr"
+        exit 1
+    }
+
+    if (!(syllable in ids)) {
+        ids[syllable] = ++count
+        syllables[count] = syllable
+
+        if (length(syllable) > maxLength)
+            maxLength = length(syllable)
+    }
+
+    table[code] = ids[syllable]
+
+    if (first < 0 || code < first)
+        first = code
+
+    if (code > last)
+        last = code
+}
+
+END {
+    if (count >= 65536) {
+        print "pinyin.dict: too many syllables" > "/dev/stderr"
+        exit 1
+    }
+
+    print "// Generated from pinyin.dict by pinyin_table.awk, do not edit."
+    print ""
+    print "#ifndef PINYIN_TABLE_H"
+    print "#define PINYIN_TABLE_H"
+    print ""
+    print "namespace Pinyin {"
+    print ""
+    printf "static constexpr unsigned short kTableFirst = 0x%x;\n", first
+    printf "static constexpr unsigned short kTableLast = 0x%x;\n", last
+    printf "static constexpr int kSyllableMaxLength = %d;\n", maxLength
+    print ""
+    print "static constexpr char kSyllables[][8] = {"
+    print "    \"\","
+
+    for (i = 1; i <= count; i++)
+        printf "    \"%s\",\n", syllables[i]
+
+    print "};"
+    print ""
+    print "static constexpr unsigned short kSyllableIndex[] = {"
+
+    line = ""
+
+    for (code = first; code <= last; code++) {
+        line = line (code in table ? table[code] : 0) ","
+
+        if ((code - first) % 16 == 15 || code == last) {
+            print "    " line
+            line = ""
+        }
+    }
+
+    print "};"
+    print ""
+    print "}  // namespace Pinyin end"
+    print ""
+    print "#endif  // PINYIN_TABLE_H"
+}
@@ -0,0 +1,59 @@
+# The sources and build settings shared by dde-file-manager.pro and the
+# benchmarks (benchmarks/common/app.pri), everything but main() and installing.
+
+include($$PWD/vendor/vendor.pri)
+
+QT       += core gui svg dbus x11extras network concurrent
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+INCLUDEPATH += $$PWD
+
+ARCH = $$QMAKE_HOST.arch
+isEqual(ARCH, sw_64) | isEqual(ARCH, mips64) | isEqual(ARCH, mips32) {
+    DEFINES += ARCH_MIPSEL CLASSICAL_SECTION LOAD_FILE_INTERVAL=150
+    DEFINES += AUTO_RESTART_DEAMON
+}
+
+isEqual(ARCH, mips64) | isEqual(ARCH, mips32) {
+    DEFINES += SPLICE_CP
+    DEFINES += MENU_DIALOG_PLUGIN
+}
+
+include($$PWD/widgets/widgets.pri)
+include($$PWD/dialogs/dialogs.pri)
+include($$PWD/utils/utils.pri)
+include($$PWD/filemonitor/filemonitor.pri)
+include($$PWD/deviceinfo/deviceinfo.pri)
+include($$PWD/dbusinterface/dbusinterface.pri)
+include($$PWD/simpleini/simpleini.pri)
+include($$PWD/chinese2pinyin/chinese2pinyin.pri)
+include($$PWD/xdnd/xdnd.pri)
+
+isEqual(ARCH, sw_64){
+    isEqual(ENABLE_SW_LABLE, YES){
+        DEFINES += SW_LABEL
+        include($$PWD/sw_label/sw_label.pri)
+        LIBS += -L$$PWD/sw_label -lfilemanager -lllsdeeplabel
+    }
+}
+
+PKGCONFIG += x11 gtk+-2.0 xcb xcb-ewmh gsettings-qt libudev x11 xext libsecret-1 gio-unix-2.0 libstartup-notification-1.0 xcb-aux
+CONFIG += c++11 link_pkgconfig
+#DEFINES += QT_NO_DEBUG_OUTPUT
+DEFINES += QT_MESSAGELOGCONTEXT
+
+LIBS += -lmagic
+
+# The trace spans of filemanager/app/tracer.h, qmake CONFIG+=no_trace removes them
+no_trace {
+    DEFINES += DISABLE_TRACE
+}
+
+# CONFIG+=no_io_uring leaves the batched small file jobs out, see filemanager/shutil/uringbatch.h
+no_io_uring {
+    DEFINES += DISABLE_IO_URING
+}
+
+include($$PWD/filemanager/filemanager.pri)
+include($$PWD/mips/plugin/plugin.pri)
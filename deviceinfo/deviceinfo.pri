@@ -2,10 +2,12 @@ HEADERS += \
     $$PWD/devicelistener.h \
     $$PWD/deviceinfo.h \
     $$PWD/udisklistener.h \
-    $$PWD/udiskdeviceinfo.h
+    $$PWD/udiskdeviceinfo.h \
+    $$PWD/pathclassifier.h
 
 SOURCES += \
     $$PWD/devicelistener.cpp \
     $$PWD/deviceinfo.cpp \
     $$PWD/udisklistener.cpp \
-    $$PWD/udiskdeviceinfo.cpp
+    $$PWD/udiskdeviceinfo.cpp \
+    $$PWD/pathclassifier.cpp
@@ -0,0 +1,253 @@
+#include "pathclassifier.h"
+
+#include <QSocketNotifier>
+#include <QFile>
+#include <QDebug>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#define MOUNT_INFO_PATH "/proc/self/mountinfo"
+
+/// mountinfo escapes space, tab, newline and backslash as \ooo
+static QString unescapeMountField(const QByteArray &field)
+{
+    QByteArray data;
+
+    data.reserve(field.size());
+
+    for (int i = 0; i < field.size(); ++i) {
+        if (field.at(i) == '\\' && i + 3 < field.size() && field.at(i + 1) >= '0' && field.at(i + 1) <= '3') {
+            data.append(char(field.mid(i + 1, 3).toInt(Q_NULLPTR, 8)));
+            i += 3;
+        } else {
+            data.append(field.at(i));
+        }
+    }
+
+    return QFile::decodeName(data);
+}
+
+int PathClassifier::Trie::insert(const QString &path)
+{
+    if (nodes.isEmpty())
+        nodes.append(Node());
+
+    int index = 0;
+
+    for (const QString &name : path.split('/', QString::SkipEmptyParts)) {
+        int child = nodes.at(index).children.value(name, -1);
+
+        if (child < 0) {
+            child = nodes.size();
+            nodes.append(Node());
+            nodes[index].children.insert(name, child);
+        }
+
+        index = child;
+    }
+
+    return index;
+}
+
+PathClassifier::PathClassifier(QObject *parent)
+    : QObject(parent)
+{
+    /// the kernel flags mountinfo with POLLPRI whenever the mount table changes
+    m_mountInfoFd = ::open(MOUNT_INFO_PATH, O_RDONLY | O_CLOEXEC);
+
+    if (m_mountInfoFd >= 0) {
+        m_mountInfoNotifier = new QSocketNotifier(m_mountInfoFd, QSocketNotifier::Exception, this);
+
+        connect(m_mountInfoNotifier, &QSocketNotifier::activated, this, &PathClassifier::reloadMounts);
+    }
+
+    m_mounts = readMountInfo();
+    rebuild();
+}
+
+PathClassifier::~PathClassifier()
+{
+    if (m_mountInfoFd >= 0)
+        ::close(m_mountInfoFd);
+}
+
+PathClassifier::Result PathClassifier::classify(const QString &path) const
+{
+    QSharedPointer<const Trie> trie;
+
+    m_mutex.lock();
+    trie = m_trie;
+    m_mutex.unlock();
+
+    Result result;
+
+    if (!trie || trie->nodes.isEmpty() || !path.startsWith('/'))
+        return result;
+
+    const QStringList &names = path.split('/', QString::SkipEmptyParts);
+    int index = 0;
+    int depth = 0;
+    int deviceDepth = -1;
+    int mountDepth = -1;
+    int mount = -1;
+
+    forever {
+        const Node &node = trie->nodes.at(index);
+
+        if (!node.deviceId.isEmpty()) {
+            if (depth < names.size())
+                result.parentDeviceId = node.deviceId;
+
+            result.deviceId = node.deviceId;
+            result.deviceMediaType = node.deviceMediaType;
+            result.inRemovableDevice = result.inRemovableDevice || node.removable;
+            deviceDepth = depth;
+        }
+
+        if (node.mount >= 0) {
+            mount = node.mount;
+            mountDepth = depth;
+        }
+
+        if (depth == names.size()) {
+            result.systemPathKey = node.systemPathKey;
+            break;
+        }
+
+        int child = node.children.value(names.at(depth), -1);
+
+        if (child < 0)
+            break;
+
+        index = child;
+        ++depth;
+    }
+
+    result.isDeviceRoot = deviceDepth >= 0 && deviceDepth == names.size();
+
+    if (mount >= 0) {
+        const Mount &info = trie->mounts.at(mount);
+
+        result.mountPoint = info.mountPoint;
+        result.mountSource = info.source;
+        result.fsType = info.fsType;
+        result.isMountRoot = mountDepth == names.size();
+    }
+
+    return result;
+}
+
+void PathClassifier::setDevices(const QList<UDiskDeviceInfo *> &devices)
+{
+    m_devices.clear();
+
+    for (UDiskDeviceInfo *info : devices) {
+        const QString &mountPoint = info->getMountPointUrl().toLocalFile();
+
+        if (mountPoint.isEmpty())
+            continue;
+
+        UDiskDeviceInfo::MediaType type = info->getMediaType();
+        bool removable = type == UDiskDeviceInfo::removable || type == UDiskDeviceInfo::iphone
+                || type == UDiskDeviceInfo::phone || type == UDiskDeviceInfo::camera;
+
+        m_devices.append({mountPoint, info->getDiskInfo().ID, type, removable});
+    }
+
+    rebuild();
+}
+
+void PathClassifier::setSystemPaths(const QMap<QString, QString> &systemPaths)
+{
+    m_systemPaths = systemPaths;
+
+    rebuild();
+}
+
+void PathClassifier::reloadMounts()
+{
+    const QVector<Mount> &mounts = readMountInfo();
+
+    if (mounts.size() == m_mounts.size()) {
+        bool changed = false;
+
+        for (int i = 0; i < mounts.size() && !changed; ++i) {
+            changed = mounts.at(i).mountPoint != m_mounts.at(i).mountPoint
+                    || mounts.at(i).source != m_mounts.at(i).source
+                    || mounts.at(i).fsType != m_mounts.at(i).fsType;
+        }
+
+        if (!changed)
+            return;
+    }
+
+    m_mounts = mounts;
+    rebuild();
+
+    emit mountsChanged();
+}
+
+QVector<PathClassifier::Mount> PathClassifier::readMountInfo()
+{
+    QVector<Mount> mounts;
+    QFile file(MOUNT_INFO_PATH);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Couldn't open" << MOUNT_INFO_PATH;
+
+        return mounts;
+    }
+
+    /// "36 35 98:0 /mnt1 /mnt2 rw,noatime master:1 - ext3 /dev/root rw,errors=continue"
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        const QList<QByteArray> &fields = line.split(' ');
+        int separator = fields.indexOf("-", 6);
+
+        if (fields.size() < 7 || separator < 0 || separator + 2 >= fields.size())
+            continue;
+
+        Mount mount;
+
+        mount.mountPoint = unescapeMountField(fields.at(4));
+        mount.fsType = QString::fromLatin1(fields.at(separator + 1));
+        mount.source = unescapeMountField(fields.at(separator + 2));
+
+        mounts.append(mount);
+    }
+
+    return mounts;
+}
+
+void PathClassifier::rebuild()
+{
+    QSharedPointer<Trie> trie(new Trie);
+
+    trie->insert("/");
+    trie->mounts = m_mounts;
+
+    /// later entries of mountinfo are mounted over the earlier ones
+    for (int i = 0; i < m_mounts.size(); ++i) {
+        int index = trie->insert(m_mounts.at(i).mountPoint);
+
+        trie->nodes[index].mount = i;
+    }
+
+    for (const Device &device : m_devices) {
+        int index = trie->insert(device.mountPoint);
+
+        trie->nodes[index].deviceId = device.id;
+        trie->nodes[index].deviceMediaType = device.mediaType;
+        trie->nodes[index].removable = device.removable;
+    }
+
+    for (auto it = m_systemPaths.constBegin(); it != m_systemPaths.constEnd(); ++it) {
+        int index = trie->insert(it.value());
+
+        trie->nodes[index].systemPathKey = it.key();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    m_trie = trie;
+}
@@ -0,0 +1,106 @@
+#ifndef PATHCLASSIFIER_H
+#define PATHCLASSIFIER_H
+
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include "udiskdeviceinfo.h"
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+class PathClassifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// devices are kept by their id, UDiskListener::getDevice() has them as
+    /// long as they're there
+    struct Result
+    {
+        /// the deepest device mounted at or above the path
+        QString deviceId;
+        UDiskDeviceInfo::MediaType deviceMediaType = UDiskDeviceInfo::unknown;
+        /// the deepest device mounted strictly above the path
+        QString parentDeviceId;
+        bool isDeviceRoot = false;
+        bool inRemovableDevice = false;
+
+        /// the file system the path lives on, from /proc/self/mountinfo
+        QString mountPoint;
+        QString mountSource;
+        QString fsType;
+        bool isMountRoot = false;
+
+        /// key of PathManager::systemPathsMap(), for the system path itself only
+        QString systemPathKey;
+    };
+
+    explicit PathClassifier(QObject *parent = 0);
+    ~PathClassifier();
+
+    Result classify(const QString &path) const;
+
+    void setDevices(const QList<UDiskDeviceInfo *> &devices);
+    void setSystemPaths(const QMap<QString, QString> &systemPaths);
+
+public slots:
+    void reloadMounts();
+
+signals:
+    void mountsChanged();
+
+private:
+    struct Mount
+    {
+        QString mountPoint;
+        QString source;
+        QString fsType;
+    };
+
+    struct Device
+    {
+        QString mountPoint;
+        QString id;
+        UDiskDeviceInfo::MediaType mediaType;
+        bool removable;
+    };
+
+    struct Node
+    {
+        QHash<QString, int> children;
+        QString deviceId;
+        UDiskDeviceInfo::MediaType deviceMediaType = UDiskDeviceInfo::unknown;
+        bool removable = false;
+        int mount = -1;
+        QString systemPathKey;
+    };
+
+    struct Trie
+    {
+        QVector<Node> nodes;
+        QVector<Mount> mounts;
+
+        int insert(const QString &path);
+    };
+
+    static QVector<Mount> readMountInfo();
+    void rebuild();
+
+    QVector<Mount> m_mounts;
+    QList<Device> m_devices;
+    QMap<QString, QString> m_systemPaths;
+
+    mutable QMutex m_mutex;
+    QSharedPointer<const Trie> m_trie;
+
+    int m_mountInfoFd = -1;
+    QSocketNotifier *m_mountInfoNotifier = Q_NULLPTR;
+};
+
+#endif // PATHCLASSIFIER_H
@@ -1,4 +1,5 @@
 #include "udisklistener.h"
+#include "pathclassifier.h"
 #include "fstab.h"
 
 #include "../../filemanager/app/global.h"
@@ -9,6 +10,11 @@
 
 #include "widgets/singleton.h"
 
+#include <QTimer>
+
+#define DISK_CHANGE_DELAY 100
+#define DISK_CHANGE_BATCH_COUNT 4
+
 UDiskListener::UDiskListener()
 {
     fileService->setFileUrlHandler(COMPUTER_SCHEME, "", this);
@@ -22,6 +28,12 @@ UDiskListener::UDiskListener()
     connect(m_diskMountInterface, &DiskMountInterface::Error,
             fileSignalManager, &FileSignalManager::showDiskErrorDialog);
     loadCustomVolumeLetters();
+
+    m_changeTimer = new QTimer(this);
+    m_changeTimer->setSingleShot(true);
+    m_changeTimer->setInterval(DISK_CHANGE_DELAY);
+
+    connect(m_changeTimer, &QTimer::timeout, this, &UDiskListener::flushChanges);
 }
 
 UDiskDeviceInfo *UDiskListener::getDevice(const QString &id)
@@ -36,12 +48,14 @@ void UDiskListener::addDevice(UDiskDeviceInfo *device)
 {
     m_map.insert(device->getDiskInfo().ID, device);
     m_list.append(device);
+    pathClassifier->setDevices(m_list);
 }
 
 void UDiskListener::removeDevice(UDiskDeviceInfo *device)
 {
     m_list.removeOne(device);
     m_map.remove(device->getDiskInfo().ID);
+    pathClassifier->setDevices(m_list);
     delete device;
 }
 
@@ -96,91 +110,38 @@ QList<UDiskDeviceInfo *> UDiskListener::getDeviceList()
 
 bool UDiskListener::isDeviceFolder(const QString &path) const
 {
-    for (int i = 0; i < m_list.size(); i++)
-    {
-        UDiskDeviceInfo * info = m_list.at(i);
-        if (info->getMountPointUrl().toLocalFile() == path){
-            return true;
-        }
-    }
-    return false;
+    return pathClassifier->classify(path).isDeviceRoot;
 }
 
 bool UDiskListener::isInDeviceFolder(const QString &path) const
 {
-    for (int i = 0; i < m_list.size(); i++)
-    {
-        UDiskDeviceInfo * info = m_list.at(i);
-        if (!info->getMountPointUrl().isEmpty()){
-            if (path.startsWith(info->getMountPointUrl().toLocalFile())){
-                return true;
-            }
-        }
-    }
-    return false;
+    return !pathClassifier->classify(path).deviceId.isEmpty();
 }
 
 bool UDiskListener::isInRemovableDeviceFolder(const QString &path) const
 {
-    QList<UDiskDeviceInfo::MediaType> mediaTypes = {UDiskDeviceInfo::removable,
-                                                    UDiskDeviceInfo::iphone,
-                                                   UDiskDeviceInfo::phone,
-                                                   UDiskDeviceInfo::camera};
-    for (int i = 0; i < m_list.size(); i++)
-    {
-        UDiskDeviceInfo * info = m_list.at(i);
-        if (mediaTypes.contains(info->getMediaType())){
-            if (!info->getMountPointUrl().isEmpty()){
-                if (path.startsWith(info->getMountPointUrl().toLocalFile())){
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
+    return pathClassifier->classify(path).inRemovableDevice;
 }
 
 UDiskDeviceInfo *UDiskListener::getDeviceByPath(const QString &path)
 {
-    for (int i = 0; i < m_list.size(); i++)
-    {
-        UDiskDeviceInfo * info = m_list.at(i);
-        if (!info->getMountPointUrl().isEmpty()){
-            bool flag = (DUrl::fromLocalFile(path) == info->getMountPointUrl());
+    const PathClassifier::Result &result = pathClassifier->classify(path);
 
-            if (path.startsWith(info->getMountPointUrl().toLocalFile()) && flag){
-                return info;
-            }
-        }
-    }
-    return NULL;
+    return result.isDeviceRoot ? m_map.value(result.deviceId) : NULL;
 }
 
 UDiskDeviceInfo *UDiskListener::getDeviceByFilePath(const QString &path)
 {
-    for (int i = 0; i < m_list.size(); i++)
-    {
-        UDiskDeviceInfo * info = m_list.at(i);
-        if (!info->getMountPointUrl().isEmpty()){
-            bool flag = (DUrl::fromLocalFile(path) == info->getMountPointUrl());
-
-            if (path.startsWith(info->getMountPointUrl().toLocalFile()) && !flag){
-                return info;
-            }
-        }
-    }
-    return NULL;
+    return m_map.value(pathClassifier->classify(path).parentDeviceId);
 }
 
 UDiskDeviceInfo::MediaType UDiskListener::getDeviceMediaType(const QString &path)
 {
-    for (int i = 0; i < m_list.size(); i++)
-    {
-        UDiskDeviceInfo * info = m_list.at(i);
-        if (info->getMountPointUrl().toLocalFile() == path){
-            return info->getMediaType();
-        }
-    }
+    const PathClassifier::Result &result = pathClassifier->classify(path);
+
+    if (result.isDeviceRoot)
+        return result.deviceMediaType;
+
     return UDiskDeviceInfo::unknown;
 }
 
@@ -216,11 +177,15 @@ QMap<QString, QString> UDiskListener::getVolumeLetters()
 
 void UDiskListener::mount(const QString &path)
 {
-    QDBusPendingReply<> reply = m_diskMountInterface->Mount(path);
-    reply.waitForFinished();
-    if (reply.isValid() && reply.isFinished()){
-        qDebug() << "mount" << path << "successed";
-    }
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_diskMountInterface->Mount(path), this);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [path] (QDBusPendingCallWatcher *call) {
+        if (!call->isError()){
+            qDebug() << "mount" << path << "successed";
+        }
+
+        call->deleteLater();
+    });
 }
 
 DiskInfo UDiskListener::queryDisk(const QString &path)
@@ -276,6 +241,8 @@ void UDiskListener::asyncRequestDiskInfosFinihsed(QDBusPendingCallWatcher *call)
             }
             mountAdded(device);
         }
+
+        pathClassifier->setDevices(m_list);
     }else{
         qCritical() << reply.error().message();
     }
@@ -288,8 +255,105 @@ void UDiskListener::changed(int in0, const QString &in1)
 {
     qDebug() << in0 << in1;
 
-    UDiskDeviceInfo *device = hasDeviceInfo(in1);
-    DiskInfo info = m_diskMountInterface->QueryDisk(in1);
+    /// a burst of changes, e.g. a hub with several partitions, is folded into
+    /// as few D-Bus round trips as possible, none of them blocking
+    m_changedIds << in1;
+
+    if (!m_changeTimer->isActive())
+        m_changeTimer->start();
+}
+
+void UDiskListener::flushChanges()
+{
+    if (m_changedIds.count() > DISK_CHANGE_BATCH_COUNT) {
+        m_changedIds.clear();
+        /// the list is newer than the running queries, they don't hold back
+        /// the ids anymore
+        m_queryingIds.clear();
+        ++m_queryGeneration;
+
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_diskMountInterface->ListDisk(), this);
+
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &UDiskListener::refreshDiskInfosFinished);
+
+        return;
+    }
+
+    QSet<QString> ids;
+
+    ids.swap(m_changedIds);
+
+    foreach (const QString &id, ids) {
+        /// queried again once the running query is done
+        if (m_queryingIds.contains(id)) {
+            m_changedIds << id;
+            continue;
+        }
+
+        m_queryingIds << id;
+
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_diskMountInterface->QueryDisk(id), this);
+
+        watcher->setProperty("id", id);
+        watcher->setProperty("generation", m_queryGeneration);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &UDiskListener::queryDiskFinished);
+    }
+}
+
+void UDiskListener::queryDiskFinished(QDBusPendingCallWatcher *call)
+{
+    const QString &id = call->property("id").toString();
+    QDBusPendingReply<DiskInfo> reply = *call;
+
+    if (call->property("generation").toInt() != m_queryGeneration) {
+        call->deleteLater();
+
+        return;
+    }
+
+    m_queryingIds.remove(id);
+
+    /// a failed query means the disk is gone, as the synchronous call used to
+    if (reply.isError()) {
+        qDebug() << id << reply.error().message();
+        applyDiskInfo(id, DiskInfo());
+    } else {
+        applyDiskInfo(id, reply.value());
+    }
+
+    call->deleteLater();
+
+    if (!m_changedIds.isEmpty() && !m_changeTimer->isActive())
+        m_changeTimer->start();
+}
+
+void UDiskListener::refreshDiskInfosFinished(QDBusPendingCallWatcher *call)
+{
+    QDBusPendingReply<DiskInfoList> reply = *call;
+
+    call->deleteLater();
+
+    if (reply.isError()) {
+        qCritical() << reply.error().message();
+        return;
+    }
+
+    QSet<QString> ids;
+
+    foreach (const DiskInfo &info, reply.value()) {
+        ids << info.ID;
+        applyDiskInfo(info.ID, info);
+    }
+
+    foreach (const QString &id, m_map.keys()) {
+        if (!ids.contains(id))
+            applyDiskInfo(id, DiskInfo());
+    }
+}
+
+void UDiskListener::applyDiskInfo(const QString &id, DiskInfo info)
+{
+    UDiskDeviceInfo *device = hasDeviceInfo(id);
 
     if (info.Icon == "drive-optical" && info.Name.startsWith("CD")){
         info.Type = "dvd";
@@ -305,6 +369,7 @@ void UDiskListener::changed(int in0, const QString &in1)
     {
         bool oldCanUnmount = device->getDiskInfo().CanUnmount;
         device->setDiskInfo(info);
+        pathClassifier->setDevices(m_list);
         if (oldCanUnmount != info.CanUnmount){
             if (info.CanUnmount){
                 emit mountAdded(device);
@@ -9,6 +9,7 @@
 #include <QDBusObjectPath>
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QDBusArgument>
 #include <QXmlStreamReader>
 #include <QDBusPendingReply>
@@ -23,6 +24,7 @@
 
 class UDiskDeviceInfo;
 class Subscriber;
+class QTimer;
 
 
 class UDiskListener : public AbstractFileController
@@ -72,8 +74,13 @@ public slots:
     void asyncRequestDiskInfosFinihsed(QDBusPendingCallWatcher *call);
     void changed(int in0, const QString &in1);
     void forceUnmount(const QString &id);
+private slots:
+    void flushChanges();
+    void queryDiskFinished(QDBusPendingCallWatcher *call);
+    void refreshDiskInfosFinished(QDBusPendingCallWatcher *call);
 private:
     void readFstab();
+    void applyDiskInfo(const QString &id, DiskInfo info);
     QList<UDiskDeviceInfo *> m_list;
     QMap<QString, UDiskDeviceInfo *> m_map;
     QMap<QString, QString> m_volumeLetters;
@@ -81,6 +88,12 @@ private:
 
     QList<Subscriber*> m_subscribers;
 
+    QSet<QString> m_changedIds;
+    QSet<QString> m_queryingIds;
+    /// bumped by a full ListDisk refresh, older QueryDisk replies are dropped
+    int m_queryGeneration = 0;
+    QTimer *m_changeTimer;
+
     DiskMountInterface* m_diskMountInterface;
 public:
     const QList<AbstractFileInfoPointer> getChildren(const DUrl &fileUrl, QDir::Filters filter, bool &accepted) const;
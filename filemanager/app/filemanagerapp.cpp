@@ -1,5 +1,6 @@
 #include "filemanagerapp.h"
 #include "filesignalmanager.h"
+#include "startupmanager.h"
 
 #include "../views/windowmanager.h"
 #include "../views/dfilemanagerwindow.h"
@@ -36,6 +37,8 @@ FileManagerApp::FileManagerApp(QObject *parent) : QObject(parent)
     initConnect();
     lazyRunCacheTask();
     loadFileJobConfig();
+
+    StartupManager::instance()->mark("file manager app");
 }
 
 FileManagerApp::~FileManagerApp()
@@ -125,6 +128,8 @@ void FileManagerApp::loadFileJobConfig()
         FileJob::Msec_For_Display = filejobSettings.value("Msec_For_Display", 1000).toLongLong();
         FileJob::Data_Block_Size = filejobSettings.value("Data_Block_Size", 65536).toLongLong();
         FileJob::Data_Flush_Size = filejobSettings.value("Data_Flush_Size", 16777216).toLongLong();
+        FileJob::Verify_Copy = filejobSettings.value("Verify_Copy", false).toBool();
+        FileJob::Use_IO_Uring = filejobSettings.value("Use_IO_Uring", false).toBool();
         filejobSettings.endGroup();
     }
 }
@@ -61,6 +61,9 @@ signals:
 
     /*copy/move job conflict dialog show */
     void conflictDialogShowed(const QMap<QString, QString>& jobDetail);
+
+    /*copy/move job copies that don't match their sources, they were removed*/
+    void jobVerifyFailed(const QMap<QString, QString>& jobDetail, const QStringList &filePaths);
 #ifdef SW_LABEL
     /*copy/move/delete fail job show */
     void jobFailed(int nRet, const QString &jobType, const QString& srcFileName);
@@ -11,6 +11,7 @@
 #define searchHistoryManager  Singleton<SearchHistroyManager>::instance()
 #define bookmarkManager  Singleton<BookMarkManager>::instance()
 #define trashManager  Singleton<TrashManager>::instance()
+#define trashInfoCache Singleton<TrashInfoCache>::instance()
 #define fileMenuManger  Singleton<FileMenuManager>::instance()
 #define fileSignalManager Singleton<FileSignalManager>::instance()
 #define dialogManager Singleton<DialogManager>::instance()
@@ -18,10 +19,15 @@
 #define fileIconProvider Singleton<IconProvider>::instance()
 #define fileService FileServices::instance()
 #define deviceListener Singleton<UDiskListener>::instance()
+#define pathClassifier Singleton<PathClassifier>::instance()
 #define mimeAppsManager Singleton<MimesAppsManager>::instance()
 #define systemPathManager Singleton<PathManager>::instance()
 #define mimeTypeDisplayManager Singleton<MimeTypeDisplayManager>::instance()
 #define thumbnailManager Singleton<ThumbnailManager>::instance()
+#define emblemManager Singleton<EmblemManager>::instance()
+#define childCountManager Singleton<ChildCountManager>::instance()
+#define directorySnapshotCache Singleton<DirectorySnapshotCache>::instance()
+#define pathCompletionEngine Singleton<PathCompletionEngine>::instance()
 #define networkManager Singleton<NetworkManager>::instance()
 #define gvfsMountClient Singleton<GvfsMountClient>::instance()
 #define secrectManager Singleton<SecrectManager>::instance()
@@ -0,0 +1,141 @@
+#include "metrics.h"
+
+#include <QDebug>
+
+void MetricHistogram::observe(qint64 value)
+{
+    int index = 0;
+
+    /// the first bucket takes up to 1, the i-th one up to 2^i
+    if (value > 1)
+        index = qMin(64 - __builtin_clzll(quint64(value - 1)), METRIC_HISTOGRAM_BUCKETS - 1);
+
+    m_buckets[index].fetchAndAddRelaxed(1);
+    m_sum.fetchAndAddRelaxed(value);
+}
+
+quint64 MetricHistogram::bucket(int index) const
+{
+    return m_buckets[index].load();
+}
+
+qint64 MetricHistogram::sum() const
+{
+    return m_sum.load();
+}
+
+quint64 MetricHistogram::count() const
+{
+    quint64 count = 0;
+
+    for (int i = 0; i < METRIC_HISTOGRAM_BUCKETS; ++i) {
+        count += bucket(i);
+    }
+
+    return count;
+}
+
+Metrics *Metrics::instance()
+{
+    static Metrics instance;
+
+    return &instance;
+}
+
+MetricCounter *Metrics::counter(const QString &name, const QString &help)
+{
+    return static_cast<MetricCounter*>(metric(name, help, Counter));
+}
+
+MetricCounter *Metrics::gauge(const QString &name, const QString &help)
+{
+    return static_cast<MetricCounter*>(metric(name, help, Gauge));
+}
+
+MetricHistogram *Metrics::histogram(const QString &name, const QString &help)
+{
+    return static_cast<MetricHistogram*>(metric(name, help, Histogram));
+}
+
+QByteArray Metrics::snapshot() const
+{
+    QByteArray text;
+    QMutexLocker locker(&m_mutex);
+
+    for (const Entry &entry : m_entries) {
+        const QByteArray &name = entry.name.toLatin1();
+
+        text += "# HELP " + name + ' ' + entry.help.toUtf8() + '\n';
+
+        switch (entry.type) {
+        case Counter:
+        case Gauge:
+            text += "# TYPE " + name + (entry.type == Counter ? " counter\n" : " gauge\n");
+            text += name + ' ' + QByteArray::number(static_cast<MetricCounter*>(entry.metric)->value()) + '\n';
+            break;
+        case Histogram: {
+            const MetricHistogram *histogram = static_cast<MetricHistogram*>(entry.metric);
+            quint64 count = 0;
+
+            text += "# TYPE " + name + " histogram\n";
+
+            /// the buckets are read one by one, so count may lag behind a
+            /// concurrent observe() but the cumulative values stay monotonic
+            for (int i = 0; i < METRIC_HISTOGRAM_BUCKETS; ++i) {
+                const QByteArray &bound = i < METRIC_HISTOGRAM_BUCKETS - 1 ? QByteArray::number(Q_UINT64_C(1) << i)
+                                                                           : QByteArray("+Inf");
+
+                count += histogram->bucket(i);
+                text += name + "_bucket{le=\"" + bound + "\"} " + QByteArray::number(count) + '\n';
+            }
+
+            text += name + "_sum " + QByteArray::number(histogram->sum()) + '\n';
+            text += name + "_count " + QByteArray::number(count) + '\n';
+            break;
+        }
+        }
+    }
+
+    return text;
+}
+
+Metrics::Metrics()
+{
+
+}
+
+Metrics::~Metrics()
+{
+    for (const Entry &entry : m_entries) {
+        if (entry.type == Histogram)
+            delete static_cast<MetricHistogram*>(entry.metric);
+        else
+            delete static_cast<MetricCounter*>(entry.metric);
+    }
+}
+
+void *Metrics::metric(const QString &name, const QString &help, Metrics::Type type)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (const Entry &entry : m_entries) {
+        if (entry.name != name)
+            continue;
+
+        if (entry.type == type)
+            return entry.metric;
+
+        qWarning() << "Metric" << name << "registered again with another type";
+    }
+
+    Entry entry{name, help, type, Q_NULLPTR};
+
+    if (type == Histogram)
+        entry.metric = new MetricHistogram;
+    else
+        entry.metric = new MetricCounter;
+
+    m_entries.append(entry);
+
+    return entry.metric;
+}
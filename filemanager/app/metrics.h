@@ -0,0 +1,87 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QList>
+
+/// histogram buckets are powers of two, the last one is +Inf
+#define METRIC_HISTOGRAM_BUCKETS 32
+
+class MetricCounter
+{
+public:
+    inline void add(qint64 value)
+    { m_value.fetchAndAddRelaxed(value);}
+    inline void increment()
+    { add(1);}
+    inline void decrement()
+    { add(-1);}
+    inline void set(qint64 value)
+    { m_value.store(value);}
+    inline qint64 value() const
+    { return m_value.load();}
+
+private:
+    QAtomicInteger<qint64> m_value;
+};
+
+class MetricHistogram
+{
+public:
+    void observe(qint64 value);
+
+    quint64 bucket(int index) const;
+    qint64 sum() const;
+    quint64 count() const;
+
+private:
+    QAtomicInteger<quint64> m_buckets[METRIC_HISTOGRAM_BUCKETS];
+    QAtomicInteger<qint64> m_sum;
+};
+
+/// Counters, gauges and histograms registered by the subsystems. Updates are
+/// single relaxed atomics, only the registration and the snapshot take the
+/// lock. The snapshot is served by the SingleApplication local server and
+/// printed by --metrics, in the Prometheus text format.
+class Metrics
+{
+public:
+    static Metrics *instance();
+
+    /// a name registered twice returns the same metric, the pointers stay
+    /// valid for the whole process
+    MetricCounter *counter(const QString &name, const QString &help);
+    MetricCounter *gauge(const QString &name, const QString &help);
+    MetricHistogram *histogram(const QString &name, const QString &help);
+
+    QByteArray snapshot() const;
+
+private:
+    enum Type {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    struct Entry
+    {
+        QString name;
+        QString help;
+        Type type;
+        void *metric;
+    };
+
+    explicit Metrics();
+    ~Metrics();
+    Q_DISABLE_COPY(Metrics)
+
+    void *metric(const QString &name, const QString &help, Type type);
+
+    mutable QMutex m_mutex;
+    QList<Entry> m_entries;
+};
+
+#endif // METRICS_H
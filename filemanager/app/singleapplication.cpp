@@ -1,6 +1,7 @@
 #include "singleapplication.h"
 #include "global.h"
 #include "filesignalmanager.h"
+#include "metrics.h"
 #include "durl.h"
 
 #include "widgets/commandlinemanager.h"
@@ -11,6 +12,8 @@
 #include <QProcess>
 #include <QDir>
 
+#include <cstdio>
+
 QString SingleApplication::UserID = "1000";
 
 SingleApplication::SingleApplication(int &argc, char **argv, int): QApplication(argc, argv)
@@ -59,6 +62,41 @@ void SingleApplication::newClientProcess(const QString &key)
     qDebug() << "The dde-file-manager is running end!";
 }
 
+bool SingleApplication::printMetrics(const QString &key)
+{
+    QLocalSocket localSocket;
+
+    localSocket.connectToServer(userServerName(key));
+
+    if (!localSocket.waitForConnected(1000)) {
+        qWarning() << "The dde-file-manager isn't running:" << localSocket.errorString();
+
+        return false;
+    }
+
+    QJsonObject message;
+
+    message.insert("request", QString("metrics"));
+    localSocket.write(QJsonDocument(message).toJson());
+    localSocket.flush();
+
+    /// the server hangs up after the snapshot
+    QByteArray snapshot;
+
+    while (localSocket.waitForReadyRead(3000)) {
+        snapshot += localSocket.readAll();
+    }
+
+    snapshot += localSocket.readAll();
+
+    if (snapshot.isEmpty())
+        return false;
+
+    std::fputs(snapshot.constData(), stdout);
+
+    return true;
+}
+
 QString SingleApplication::userServerName(const QString &key)
 {
     QString userKey;
@@ -120,6 +158,17 @@ void SingleApplication::readData()
     QJsonObject messageObj = QJsonDocument::fromJson(QByteArray(static_cast<QLocalSocket*>(sender())->readAll()), error).object();
     qDebug() << messageObj << error->errorString();
 
+    /// scrapers send {"request": "metrics"} and get the text snapshot back
+    if (messageObj.value("request").toString() == "metrics") {
+        QLocalSocket *socket = static_cast<QLocalSocket*>(sender());
+
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        socket->write(Metrics::instance()->snapshot());
+        socket->disconnectFromServer();
+
+        return;
+    }
+
     DUrl url = DUrl::fromLocalFile(QDir::homePath());
     bool isNewWindow = false;
     if (messageObj.contains("url")){
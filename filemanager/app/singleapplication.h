@@ -14,6 +14,7 @@ public:
     void initConnect();
 
     static void newClientProcess(const QString& key);
+    static bool printMetrics(const QString& key);
     static QString userServerName(const QString& key);
     static QString userID();
     static QString UserID;
@@ -0,0 +1,151 @@
+#include "startupmanager.h"
+#include "tracer.h"
+#include "metrics.h"
+
+#include <QApplication>
+#include <QWidget>
+#include <QEvent>
+#include <QTimer>
+#include <QDebug>
+
+StartupManager *StartupManager::instance()
+{
+    static StartupManager instance;
+
+    return &instance;
+}
+
+void StartupManager::mark(const char *phase)
+{
+    qint64 now = Tracer::now();
+
+    m_timeline << Phase{phase, m_lastMark, now};
+    m_lastMark = now;
+}
+
+void StartupManager::addDeferredTask(const char *name, const std::function<void()> &task)
+{
+    if (m_finished) {
+        runDeferredTask(DeferredTask{name, task});
+
+        return;
+    }
+
+    m_deferredTasks << DeferredTask{name, task};
+}
+
+void StartupManager::ensure(const char *name)
+{
+    for (int i = 0; i < m_deferredTasks.count(); ++i) {
+        if (qstrcmp(m_deferredTasks.at(i).name, name) == 0) {
+            runDeferredTask(m_deferredTasks.takeAt(i));
+
+            return;
+        }
+    }
+}
+
+void StartupManager::runDeferredTasksAfterFirstFrame()
+{
+    if (m_finished || m_waitingForFirstFrame)
+        return;
+
+    m_waitingForFirstFrame = true;
+    qApp->installEventFilter(this);
+}
+
+void StartupManager::runDeferredTasks()
+{
+    if (m_waitingForFirstFrame) {
+        m_waitingForFirstFrame = false;
+        qApp->removeEventFilter(this);
+    }
+
+    while (!m_deferredTasks.isEmpty()) {
+        runDeferredTask(m_deferredTasks.takeFirst());
+    }
+
+    finish();
+}
+
+bool StartupManager::eventFilter(QObject *watched, QEvent *event)
+{
+    /// the window paints within the expose handling, the queued call runs
+    /// once that frame has been flushed
+    if (m_waitingForFirstFrame && event->type() == QEvent::Paint
+            && watched->isWidgetType() && static_cast<QWidget*>(watched)->isWindow()) {
+        m_waitingForFirstFrame = false;
+        qApp->removeEventFilter(this);
+
+        QMetaObject::invokeMethod(this, "onFirstFrame", Qt::QueuedConnection);
+    }
+
+    return false;
+}
+
+void StartupManager::onFirstFrame()
+{
+    mark("first frame");
+    m_firstFrame = m_lastMark - m_origin;
+
+    runNextDeferredTask();
+}
+
+void StartupManager::runNextDeferredTask()
+{
+    if (m_deferredTasks.isEmpty()) {
+        finish();
+
+        return;
+    }
+
+    runDeferredTask(m_deferredTasks.takeFirst());
+
+    /// one per turn, input that arrives meanwhile isn't held up by the rest
+    QTimer::singleShot(0, this, &StartupManager::runNextDeferredTask);
+}
+
+StartupManager::StartupManager(QObject *parent)
+    : QObject(parent)
+    , m_origin(Tracer::now())
+    , m_lastMark(m_origin)
+{
+
+}
+
+void StartupManager::runDeferredTask(const StartupManager::DeferredTask &task)
+{
+    qint64 begin = Tracer::now();
+
+    task.task();
+
+    m_timeline << Phase{task.name, begin, Tracer::now()};
+}
+
+void StartupManager::finish()
+{
+    if (m_finished)
+        return;
+
+    m_finished = true;
+
+    qint64 idle = Tracer::now() - m_origin;
+
+    for (const Phase &phase : m_timeline) {
+        qDebug("startup: %-24s %8.1f ms, done at %8.1f ms", phase.name,
+               (phase.end - phase.begin) / 1e6, (phase.end - m_origin) / 1e6);
+
+        if (Tracer::isEnabled())
+            Tracer::record(phase.name, phase.begin, phase.end);
+    }
+
+    Metrics::instance()->gauge("startup_idle_ms", "Time from main() until the deferred initialization was done")->set(idle / 1000000);
+
+    if (m_firstFrame < 0)
+        return;
+
+    Metrics::instance()->gauge("startup_first_frame_ms", "Time from main() until the first window was painted")->set(m_firstFrame / 1000000);
+
+    if (m_firstFrame > qint64(STARTUP_FIRST_FRAME_BUDGET) * 1000000)
+        qWarning() << "First frame after" << m_firstFrame / 1000000 << "ms, the budget is" << STARTUP_FIRST_FRAME_BUDGET << "ms";
+}
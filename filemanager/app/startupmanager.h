@@ -0,0 +1,73 @@
+#ifndef STARTUPMANAGER_H
+#define STARTUPMANAGER_H
+
+#include <QObject>
+#include <QList>
+
+#include <functional>
+
+/// first frame target on a warm cache, in milliseconds
+#define STARTUP_FIRST_FRAME_BUDGET 150
+
+/// Orders the cold start: the first window is shown with only what its URL
+/// needs, everything else is queued as a deferred task that runs one per
+/// event loop turn once the window has painted, or earlier by ensure() on
+/// its first use. The phases make up a startup timeline that goes to the
+/// log, to the metrics and, when tracing, to the trace.
+class StartupManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StartupManager *instance();
+
+    /// \a phase must be a string literal, it ends at the time of the call
+    void mark(const char *phase);
+
+    void addDeferredTask(const char *name, const std::function<void()> &task);
+    void ensure(const char *name);
+
+    /// runs the deferred tasks once a top level window has painted
+    void runDeferredTasksAfterFirstFrame();
+    /// for the windowless daemon mode, there won't be a first frame
+    void runDeferredTasks();
+
+    inline bool isFinished() const
+    { return m_finished;}
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) Q_DECL_OVERRIDE;
+
+private slots:
+    void onFirstFrame();
+    void runNextDeferredTask();
+
+private:
+    struct Phase
+    {
+        const char *name;
+        qint64 begin;
+        qint64 end;
+    };
+
+    struct DeferredTask
+    {
+        const char *name;
+        std::function<void()> task;
+    };
+
+    explicit StartupManager(QObject *parent = 0);
+
+    void runDeferredTask(const DeferredTask &task);
+    void finish();
+
+    qint64 m_origin;
+    qint64 m_lastMark;
+    qint64 m_firstFrame = -1;
+    QList<Phase> m_timeline;
+    QList<DeferredTask> m_deferredTasks;
+    bool m_waitingForFirstFrame = false;
+    bool m_finished = false;
+};
+
+#endif // STARTUPMANAGER_H
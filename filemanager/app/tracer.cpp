@@ -0,0 +1,266 @@
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QSocketNotifier>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QVector>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+/// events kept per thread, a power of two
+#define TRACE_BUFFER_SIZE 8192
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    qint64 begin;
+    qint64 end;
+    int tid;
+};
+
+/// written by its thread only, read by dump()
+struct ThreadBuffer
+{
+    TraceEvent events[TRACE_BUFFER_SIZE];
+    QAtomicInteger<quint32> head;
+};
+
+QMutex buffersMutex;
+QList<ThreadBuffer*> buffers;
+QList<ThreadBuffer*> freeBuffers;
+QHash<int, QString> threadNames;
+
+/// hands its buffer back when the thread ends, a JobController per
+/// directory would otherwise leave a buffer behind for each of them
+struct ThreadBufferHolder
+{
+    ThreadBuffer *buffer = Q_NULLPTR;
+    int tid = 0;
+
+    ThreadBuffer *acquire()
+    {
+        QThread *thread = QThread::currentThread();
+        QString name = thread->objectName();
+
+        if (name.isEmpty())
+            name = qApp && thread == qApp->thread() ? QStringLiteral("main") : thread->metaObject()->className();
+
+        tid = int(::syscall(SYS_gettid));
+
+        QMutexLocker locker(&buffersMutex);
+
+        if (freeBuffers.isEmpty()) {
+            buffer = new ThreadBuffer;
+            buffers.append(buffer);
+        } else {
+            buffer = freeBuffers.takeLast();
+        }
+
+        threadNames[tid] = name;
+
+        return buffer;
+    }
+
+    ~ThreadBufferHolder()
+    {
+        if (!buffer)
+            return;
+
+        QMutexLocker locker(&buffersMutex);
+
+        freeBuffers.append(buffer);
+    }
+};
+
+thread_local ThreadBufferHolder bufferHolder;
+
+int signalFds[2] = {-1, -1};
+
+void onSignal(int)
+{
+    char c = 1;
+
+    /// only async-signal-safe calls here, the notifier does the rest
+    if (::write(signalFds[0], &c, sizeof(c)) < 0)
+        return;
+}
+
+}
+
+QAtomicInt Tracer::enabled;
+
+Tracer *Tracer::instance()
+{
+    static Tracer instance;
+
+    return &instance;
+}
+
+qint64 Tracer::now()
+{
+    struct timespec ts;
+
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void Tracer::record(const char *name, qint64 begin, qint64 end)
+{
+    ThreadBuffer *buffer = bufferHolder.buffer ? bufferHolder.buffer : bufferHolder.acquire();
+    quint32 index = buffer->head.load();
+    TraceEvent &event = buffer->events[index & (TRACE_BUFFER_SIZE - 1)];
+
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    event.tid = bufferHolder.tid;
+
+    buffer->head.storeRelease(index + 1);
+}
+
+void Tracer::start(const QString &filePath)
+{
+    m_filePath = filePath;
+    enabled.store(1);
+
+    qDebug() << "Tracing started, spans go to" << m_filePath;
+}
+
+bool Tracer::dump() const
+{
+    return dump(m_filePath);
+}
+
+bool Tracer::dump(const QString &filePath) const
+{
+    QJsonArray events;
+    qint64 pid = QCoreApplication::applicationPid();
+
+    buffersMutex.lock();
+
+    for (ThreadBuffer *buffer : buffers) {
+        quint32 head = buffer->head.loadAcquire();
+        quint32 first = head > TRACE_BUFFER_SIZE ? head - TRACE_BUFFER_SIZE : 0;
+        QVector<TraceEvent> copy;
+
+        copy.reserve(head - first);
+
+        for (quint32 i = first; i != head; ++i) {
+            copy.append(buffer->events[i & (TRACE_BUFFER_SIZE - 1)]);
+        }
+
+        /// the owner kept writing meanwhile, drop the oldest events it may
+        /// have overwritten, including the one it is writing right now
+        quint32 available = head - first;
+        quint32 overwritten = buffer->head.loadAcquire() - head + 1;
+        quint32 lost = available + overwritten > TRACE_BUFFER_SIZE
+                ? qMin(available, available + overwritten - TRACE_BUFFER_SIZE) : 0;
+
+        for (quint32 i = lost; i < available; ++i) {
+            const TraceEvent &event = copy.at(i);
+            QJsonObject object;
+
+            object["name"] = QString::fromLatin1(event.name);
+            object["ph"] = QStringLiteral("X");
+            object["ts"] = event.begin / 1000.0;
+            object["dur"] = (event.end - event.begin) / 1000.0;
+            object["pid"] = pid;
+            object["tid"] = event.tid;
+
+            events.append(object);
+        }
+    }
+
+    for (auto it = threadNames.constBegin(); it != threadNames.constEnd(); ++it) {
+        QJsonObject object;
+        QJsonObject args;
+
+        args["name"] = it.value();
+        object["name"] = QStringLiteral("thread_name");
+        object["ph"] = QStringLiteral("M");
+        object["pid"] = pid;
+        object["tid"] = it.key();
+        object["args"] = args;
+
+        events.append(object);
+    }
+
+    buffersMutex.unlock();
+
+    QJsonObject trace;
+
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = QStringLiteral("ms");
+
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Couldn't write the trace to" << filePath;
+
+        return false;
+    }
+
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+
+    qDebug() << "Trace with" << events.count() << "events written to" << filePath;
+
+    return true;
+}
+
+void Tracer::installSignalHandler()
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, signalFds) != 0) {
+        qWarning() << "Couldn't create the trace signal socket";
+
+        return;
+    }
+
+    QSocketNotifier *notifier = new QSocketNotifier(signalFds[1], QSocketNotifier::Read, this);
+
+    connect(notifier, &QSocketNotifier::activated, this, &Tracer::onSignalActivated);
+
+    struct sigaction action;
+
+    action.sa_handler = onSignal;
+    ::sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+
+    ::sigaction(SIGUSR1, &action, Q_NULLPTR);
+}
+
+void Tracer::onSignalActivated()
+{
+    char c;
+
+    if (::read(signalFds[1], &c, sizeof(c)) <= 0)
+        return;
+
+    if (!isEnabled()) {
+        start(m_filePath.isEmpty() ? QString("%1/dde-file-manager-%2.trace.json")
+                                     .arg(QDir::tempPath()).arg(QCoreApplication::applicationPid())
+                                   : m_filePath);
+    } else {
+        dump();
+    }
+}
+
+Tracer::Tracer(QObject *parent)
+    : QObject(parent)
+{
+
+}
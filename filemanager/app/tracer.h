@@ -0,0 +1,74 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QObject>
+#include <QString>
+#include <QAtomicInt>
+
+/// Scoped trace spans of the hot paths, off until tracing is started with
+/// --trace <file> or SIGUSR1. A disabled span costs one relaxed atomic load,
+/// building with CONFIG+=no_trace removes them altogether.
+#ifndef DISABLE_TRACE
+#define TRACE_SPAN_CONCAT_(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceSpan TRACE_SPAN_CONCAT(_traceSpan, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)
+#endif
+
+class Tracer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Tracer *instance();
+
+    static inline bool isEnabled()
+    { return enabled.load();}
+
+    static qint64 now();
+    /// \a name must be a string literal, only the pointer is recorded
+    static void record(const char *name, qint64 begin, qint64 end);
+
+    void start(const QString &filePath);
+    bool dump() const;
+    bool dump(const QString &filePath) const;
+
+    /// SIGUSR1 starts tracing when it is off and dumps the spans when it is on
+    void installSignalHandler();
+
+private slots:
+    void onSignalActivated();
+
+private:
+    explicit Tracer(QObject *parent = 0);
+
+    static QAtomicInt enabled;
+
+    QString m_filePath;
+};
+
+#ifndef DISABLE_TRACE
+class TraceSpan
+{
+public:
+    inline explicit TraceSpan(const char *name)
+        : m_name(name)
+        , m_begin(Tracer::isEnabled() ? Tracer::now() : -1)
+    {}
+
+    inline ~TraceSpan()
+    {
+        if (m_begin >= 0)
+            Tracer::record(m_name, m_begin, Tracer::now());
+    }
+
+private:
+    Q_DISABLE_COPY(TraceSpan)
+
+    const char *m_name;
+    qint64 m_begin;
+};
+#endif
+
+#endif // TRACER_H
@@ -10,6 +10,8 @@
 #include "../app/filesignalmanager.h"
 
 #include "../shutil/fileutils.h"
+#include "../shutil/emblemmanager.h"
+#include "../shutil/childcountmanager.h"
 
 #include "../dialogs/dialogmanager.h"
 
@@ -393,6 +395,9 @@ bool FileController::createSymlink(const DUrl &fileUrl, const DUrl &linkToUrl, b
 void FileController::onFileCreated(const QString &filePath)
 {
     DUrl url = DUrl::fromLocalFile(filePath);
+
+    childCountManager->removeChildCount(url.parentUrl().toLocalFile());
+
     emit childrenAdded(url);
 
     if (FileJob::selectionAndRenameFile.first == url){
@@ -407,7 +412,13 @@ void FileController::onFileCreated(const QString &filePath)
 
 void FileController::onFileRemove(const QString &filePath)
 {
-    emit childrenRemoved(DUrl::fromLocalFile(filePath));
+    const DUrl &url = DUrl::fromLocalFile(filePath);
+
+    emblemManager->removeEmblems(filePath);
+    childCountManager->removeChildCount(filePath);
+    childCountManager->removeChildCount(url.parentUrl().toLocalFile());
+
+    emit childrenRemoved(url);
 }
 
 void FileController::onFileInfoChanged(const QString &filePath)
@@ -415,6 +426,7 @@ void FileController::onFileInfoChanged(const QString &filePath)
     const DUrl &url = DUrl::fromLocalFile(filePath);
 
     FileInfo::canRenameCacheMap.remove(url);
+    emblemManager->removeEmblems(filePath);
 
     emit childrenUpdated(url);
 }
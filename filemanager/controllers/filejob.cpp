@@ -1,7 +1,11 @@
 #include "filejob.h"
 #include "../app/global.h"
 #include "../app/filesignalmanager.h"
+#include "../app/tracer.h"
+#include "../app/metrics.h"
 #include "../shutil/fileutils.h"
+#include "../shutil/trashinfocache.h"
+#include "../shutil/copyverifier.h"
 
 #include "widgets/singleton.h"
 #include "deviceinfo/udisklistener.h"
@@ -15,9 +19,12 @@
 #include <QDirIterator>
 #include <QProcess>
 #include <QCryptographicHash>
+#include <QMutex>
+#include <QHash>
 
 #include <fcntl.h>
 #include <unistd.h>
+#include <errno.h>
 #include <sys/types.h>
 #include <stdio.h>
 #include <string.h>
@@ -25,17 +32,133 @@
 #include <sys/stat.h>
 #include <sys/syscall.h>
 
+/// files handed to the io_uring batch at once
+#define URING_COPY_BATCH_SIZE 256
+#define DUPLICATE_NAME_CACHE_MAX_COUNT 1024
+
+#ifndef RENAME_NOREPLACE
+#define RENAME_NOREPLACE (1 << 0)
+#endif
+#ifndef RENAME_EXCHANGE
+#define RENAME_EXCHANGE (1 << 1)
+#endif
+
 #ifdef SW_LABEL
 #include "sw_label/filemanager.h"
 #include "sw_label/llsdeeplabel.h"
 #endif
 
+/// the next "(copy N)" number to try for a name, pasting the same file again
+/// doesn't probe all the copies before it
+class DuplicateNameCache
+{
+public:
+    int nextNumber(const QString &filePath)
+    {
+        QMutexLocker locker(&mutex);
+
+        return numbers.value(filePath, 1);
+    }
+
+    void setNextNumber(const QString &filePath, int number)
+    {
+        QMutexLocker locker(&mutex);
+
+        if (numbers.count() >= DUPLICATE_NAME_CACHE_MAX_COUNT && !numbers.contains(filePath))
+            numbers.clear();
+
+        numbers[filePath] = number;
+    }
+
+private:
+    QMutex mutex;
+    QHash<QString, int> numbers;
+};
+
+#define duplicateNameCache Singleton<DuplicateNameCache>::instance()
+
+static bool pathExists(const QString &filePath)
+{
+    struct stat st;
+
+    return ::lstat(QFile::encodeName(filePath).constData(), &st) == 0;
+}
+
+static QString duplicateName(const QFileInfo &startInfo, const QString &cpy, int num)
+{
+    const QString &copyText = num == 1 ? cpy : QString("%1 %2").arg(cpy, QString::number(num));
+
+    if (startInfo.isDir())
+        return QString("%1/%2(%3)").arg(startInfo.absolutePath(), startInfo.fileName(), copyText);
+
+    return QString("%1/%2(%3).%4").arg(startInfo.absolutePath(), startInfo.baseName(),
+                                       copyText, startInfo.completeSuffix());
+}
+
+/// renameat2() isn't in every libc and not every file system supports it
+static int renameFile(const QByteArray &from, const QByteArray &to, unsigned int flags)
+{
+#ifdef SYS_renameat2
+    return ::syscall(SYS_renameat2, AT_FDCWD, from.constData(), AT_FDCWD, to.constData(), flags);
+#else
+    Q_UNUSED(from)
+    Q_UNUSED(to)
+    Q_UNUSED(flags)
+
+    errno = ENOSYS;
+
+    return -1;
+#endif
+}
+
+/// fails with EEXIST instead of replacing \a to
+static int renameNoReplace(const QByteArray &from, const QByteArray &to)
+{
+    if (renameFile(from, to, RENAME_NOREPLACE) == 0)
+        return 0;
+
+    if (errno != ENOSYS && errno != EINVAL)
+        return -1;
+
+    /// link() doesn't replace either, it fails for directories though
+    if (::link(from.constData(), to.constData()) == 0)
+        return ::unlink(from.constData());
+
+    if (errno == EEXIST)
+        return -1;
+
+    struct stat st;
+
+    if (::lstat(to.constData(), &st) == 0) {
+        errno = EEXIST;
+
+        return -1;
+    }
+
+    return ::rename(from.constData(), to.constData());
+}
+
+static QByteArray handlePath(int fd)
+{
+    return "/proc/self/fd/" + QByteArray::number(fd);
+}
+
+/// short whatever the name of the target is, a name at NAME_MAX still fits
+static QString temporaryPath(const QString &dirPath, int attempt)
+{
+    return QString("%1/.dfm-%2-%3~").arg(dirPath).arg(::getpid()).arg(attempt);
+}
+
 QPair<DUrl, int> FileJob::selectionAndRenameFile;
 
 int FileJob::FileJobCount = 0;
 qint64 FileJob::Msec_For_Display = 1000;
 qint64 FileJob::Data_Block_Size = 65536;
 qint64 FileJob::Data_Flush_Size = 16777216;
+bool FileJob::Verify_Copy = false;
+/// off until filejob.copy.uring and filejob.delete.uring of bench_engines
+/// show a gain over the file by file path on the hardware it's turned on for
+bool FileJob::Use_IO_Uring = false;
 
 
 void FileJob::setStatus(FileJob::Status status)
@@ -44,7 +167,10 @@ void FileJob::setStatus(FileJob::Status status)
 }
 
 FileJob::FileJob(const QString &type, QObject *parent) : QObject(parent)
+  , m_activeJobs(Metrics::instance()->gauge("filejob_active", "File jobs alive"))
+  , m_copiedBytes(Metrics::instance()->counter("filejob_copied_bytes_total", "Bytes written by copy and move jobs"))
 {
+    m_activeJobs->increment();
     FileJobCount += 1;
     m_status = FileJob::Started;
     QString user = getenv("USER");
@@ -63,6 +189,10 @@ FileJob::FileJob(const QString &type, QObject *parent) : QObject(parent)
 
 FileJob::~FileJob()
 {
+    m_activeJobs->decrement();
+    delete m_verifier;
+    delete m_uringBatch;
+
 #ifdef SPLICE_CP
     close(m_filedes[0]);
     close(m_filedes[1]);
@@ -80,45 +210,30 @@ QString FileJob::getJobId()
     return m_id;
 }
 
+/// the first free name of "name(copy).suffix", "name(copy 2).suffix", ... The
+/// name is only free when it's checked, the callers take it exclusively and
+/// ask again when they lose it.
 QString FileJob::checkDuplicateName(const QString &name)
 {
-    QString destUrl = name;
-    QFile file(destUrl);
-    QFileInfo startInfo(destUrl);
-    int num = 1;
+    if (!pathExists(name))
+        return name;
+
+    QFileInfo startInfo(name);
     QString cpy = tr("copy");
-    while (file.exists())
-    {
-        if(num == 1)
-        {
-            if(startInfo.isDir())
-                destUrl = QString("%1/%2(%3)").arg(startInfo.absolutePath(),
-                                                   startInfo.fileName(),
-                                                   cpy);
-            else
-                destUrl = QString("%1/%2(%3).%4").arg(startInfo.absolutePath(),
-                                                      startInfo.baseName(),
-                                                      cpy,
-                                                      startInfo.completeSuffix());
-        }
-        else
-        {
-            if(startInfo.isDir())
-                destUrl = QString("%1/%2(%3 %4)").arg(startInfo.absolutePath(),
-                                                      startInfo.fileName(),
-                                                      cpy,
-                                                      QString::number(num));
-            else
-                destUrl = QString("%1/%2(%3 %4).%5").arg(startInfo.absolutePath(),
-                                                         startInfo.baseName(),
-                                                         cpy,
-                                                         QString::number(num),
-                                                         startInfo.completeSuffix()
-                                                         );
-        }
-        num++;
-        file.setFileName(destUrl);
+    int num = duplicateNameCache->nextNumber(name);
+
+    /// the copies before it were removed meanwhile
+    if (num > 1 && !pathExists(duplicateName(startInfo, cpy, num - 1)))
+        num = 1;
+
+    QString destUrl = duplicateName(startInfo, cpy, num);
+
+    while (pathExists(destUrl)) {
+        destUrl = duplicateName(startInfo, cpy, ++num);
     }
+
+    duplicateNameCache->setNextNumber(name, num + 1);
+
     return destUrl;
 }
 
@@ -167,16 +282,23 @@ DUrlList FileJob::doCopy(const DUrlList &files, const QString &destination)
         QDir srcDir(url.toLocalFile());
         QString targetPath;
 
+        bool ok;
+
         if(srcDir.exists())
-            copyDir(url.toLocalFile(), QUrl(destination).toLocalFile(), false,  &targetPath);
+            ok = copyDir(url.toLocalFile(), QUrl(destination).toLocalFile(), false,  &targetPath);
         else
-            copyFile(url.toLocalFile(), QUrl(destination).toLocalFile(), false,  &targetPath);
+            ok = copyFile(url.toLocalFile(), QUrl(destination).toLocalFile(), false,  &targetPath);
 
-        if (!targetPath.isEmpty())
+        if (!ok)
+            qDebug() << "copy of" << url << "failed";
+
+        /// a directory is there even if some of its files failed
+        if (!targetPath.isEmpty() && (ok || srcDir.exists()))
             list << DUrl::fromLocalFile(targetPath);
     }
     if(m_isJobAdded)
         jobRemoved();
+    jobVerifyFailed();
     emit finished();
     qDebug() << "Do copy is done!";
 
@@ -317,6 +439,7 @@ DUrlList FileJob::doMove(const DUrlList &files, const QString &destination)
     }
     if(m_isJobAdded)
         jobRemoved();
+    jobVerifyFailed();
     emit finished();
     qDebug() << "Do move is done!";
 
@@ -333,7 +456,12 @@ void FileJob::doTrashRestore(const QString &srcFile, const QString &tarFile)
     m_totalSize = FileUtils::totalSize(files);
     jobPrepared();
 
-    restoreTrashFile(srcFile, tarFile);
+    if (restoreTrashFile(srcFile, tarFile) && !QFile::exists(srcFile)) {
+        const QFileInfo srcInfo(srcFile);
+
+        if (srcInfo.absolutePath() == QDir(TRASHFILEPATH).absolutePath())
+            trashInfoCache->removeTrashInfo(srcInfo.fileName());
+    }
 
     if(m_isJobAdded)
         jobRemoved();
@@ -477,8 +605,20 @@ void FileJob::jobConflicted()
     m_status = Paused;
 }
 
+/// the copies that failed their check are reported once, when the job is done
+void FileJob::jobVerifyFailed()
+{
+    if (m_verifyFailedFiles.isEmpty())
+        return;
+
+    emit fileSignalManager->jobVerifyFailed(m_jobDetail, m_verifyFailedFiles);
+    m_verifyFailedFiles.clear();
+}
+
 bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMoved, QString *targetPath)
-{   
+{
+    TRACE_SCOPE("FileJob::copyFile");
+
 #ifdef SW_LABEL
     bool isLabelFileFlag = isLabelFile(srcFile);
     if (isLabelFileFlag){
@@ -540,6 +680,14 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
 #else
     char block[Data_Block_Size];
 #endif
+    /// a sparse source is copied extent by extent, the holes are left unwritten
+    bool isSparse = false;
+    qint64 sparseSize = 0;
+    qint64 sparseOffset = 0;
+    qint64 sparseExtentEnd = 0;
+    QByteArray sparseBlock;
+    bool replaceTarget = false;
+    bool isUnnamedTarget = false;
 
     while(true)
     {
@@ -555,6 +703,8 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
                     }
                     else
                     {
+                        replaceTarget = true;
+
                         if(!m_applyToAll)
                             m_isReplaced = false;
                     }
@@ -567,19 +717,30 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
                     return false;
                 }
 
-                if(!to.open(QIODevice::WriteOnly))
+                if(!openTarget(to, &isUnnamedTarget))
                 {
                     //Operation failed
-                    qDebug() << to.fileName() << to.error() << to.errorString() << "isn't write only";
-                    QString toFileName =  tarDir + "/" + DUrl::toPercentEncoding(m_srcFileName);
-                    qDebug() << "toPercentEncoding" <<  toFileName;
-                    to.setFileName(toFileName);
-                    if (!to.open(QIODevice::WriteOnly)){
-                        qDebug() << to.fileName() << to.error() <<to.errorString() << "isn't write only";
-                        return false;
-                    }
+                    from.close();
+                    return false;
                 }
                 m_status = Run;
+
+                if (Verify_Copy) {
+                    if (!m_verifier)
+                        m_verifier = new CopyVerifier(Data_Block_Size);
+#ifndef SPLICE_CP
+                    m_verifier->start();
+#endif
+                }
+
+                struct stat fromStat;
+
+                if (::fstat(from.handle(), &fromStat) == 0 && S_ISREG(fromStat.st_mode)
+                        && qint64(fromStat.st_blocks) * 512 < fromStat.st_size) {
+                    isSparse = true;
+                    sparseSize = fromStat.st_size;
+                    sparseBlock.resize(Data_Block_Size);
+                }
  #ifdef SPLICE_CP
                 in_fd = from.handle();
                 out_fd = to.handle();
@@ -591,6 +752,85 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
             }
             case FileJob::Run:
             {
+                if (isSparse) {
+                    if (sparseOffset >= sparseExtentEnd && sparseOffset < sparseSize) {
+                        off_t dataOffset = ::lseek(from.handle(), sparseOffset, SEEK_DATA);
+
+                        if (dataOffset < 0 && errno != ENXIO) {
+                            /// no SEEK_DATA here, copy it as a whole from where we are
+                            qDebug() << "SEEK_DATA failed on" << srcFile << strerror(errno);
+                            isSparse = false;
+#ifdef SPLICE_CP
+                            in_off = sparseOffset;
+                            out_off = sparseOffset;
+                            len = sparseSize - sparseOffset;
+#else
+                            from.seek(sparseOffset);
+                            to.seek(sparseOffset);
+#endif
+
+                            break;
+                        }
+
+                        /// ENXIO: only a hole is left
+                        const qint64 holeEnd = dataOffset < 0 ? sparseSize : dataOffset;
+
+                        m_totalSize -= holeEnd - sparseOffset;
+
+                        if (m_verifier)
+                            m_verifier->feedZeros(holeEnd - sparseOffset);
+
+                        sparseOffset = holeEnd;
+
+                        if (sparseOffset < sparseSize) {
+                            off_t holeOffset = ::lseek(from.handle(), sparseOffset, SEEK_HOLE);
+
+                            sparseExtentEnd = holeOffset < 0 ? sparseSize : holeOffset;
+                        }
+                    }
+
+                    if (sparseOffset >= sparseSize) {
+                        /// recreates a trailing hole, the target was truncated when opened
+                        if (::ftruncate(to.handle(), sparseSize) != 0) {
+                            qDebug() << "ftruncate failed on" << m_tarPath << strerror(errno);
+                            discardCopy(from, to, isUnnamedTarget);
+
+                            return false;
+                        }
+
+                        if ((m_totalSize - m_bytesCopied) <= 1){
+                            m_bytesCopied = m_totalSize;
+                        }
+
+                        return finishCopy(from, to, isUnnamedTarget, replaceTarget, targetPath);
+                    }
+
+                    const qint64 size = qMin(qint64(sparseBlock.size()), sparseExtentEnd - sparseOffset);
+                    const ssize_t inBytes = ::pread(from.handle(), sparseBlock.data(), size, sparseOffset);
+
+                    if (inBytes <= 0 || ::pwrite(to.handle(), sparseBlock.constData(), inBytes, sparseOffset) != inBytes) {
+                        qDebug() << "copy of" << srcFile << "failed at" << sparseOffset << strerror(errno);
+                        discardCopy(from, to, isUnnamedTarget);
+
+                        return false;
+                    }
+
+                    if (m_verifier)
+                        m_verifier->feed(sparseBlock.constData(), inBytes);
+
+                    sparseOffset += inBytes;
+                    m_bytesCopied += inBytes;
+                    m_bytesPerSec += inBytes;
+                    m_copiedBytes->add(inBytes);
+
+                    if (!m_isInSameDisk){
+                        if (m_bytesCopied % (Data_Flush_Size) == 0){
+                            fsync(to.handle());
+                        }
+                    }
+
+                    break;
+                }
 
 #ifdef SPLICE_CP
                 if(len <= 0)
@@ -601,13 +841,8 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
 
                     to.flush();
 //                    fsync(out_fd);
-                    from.close();
-                    to.close();
-
-                    if (targetPath)
-                        *targetPath = m_tarPath;
 
-                    return true;
+                    return finishCopy(from, to, isUnnamedTarget, replaceTarget, targetPath);
                 }
 
                 if(buf_size > len)
@@ -618,6 +853,7 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
                 err = splice(in_fd, &in_off, m_filedes[1], NULL, buf_size, SPLICE_F_MOVE);
                 if(err < 0) {
                     qDebug() << "splice pipe0 fail";
+                    discardCopy(from, to, isUnnamedTarget);
                     return false;
                 }
 
@@ -631,12 +867,14 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
                 err = splice(m_filedes[0], NULL, out_fd, &out_off, buf_size, SPLICE_F_MOVE );
                 if(err < 0) {
                     qDebug() << "splice pipe1 fail";
+                    discardCopy(from, to, isUnnamedTarget);
                     return false;
                 }
                 len -= buf_size;
 
                 m_bytesCopied += buf_size;
                 m_bytesPerSec += buf_size;
+                m_copiedBytes->add(buf_size);
 
                 if (!m_isInSameDisk){
                     if (m_bytesCopied % (Data_Flush_Size) == 0){
@@ -650,31 +888,26 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
                         m_bytesCopied = m_totalSize;
                     }
                     to.flush();
-                    from.close();
-                    to.close();
 
-                    if (targetPath)
-                        *targetPath = m_tarPath;
-
-                    return true;
+                    return finishCopy(from, to, isUnnamedTarget, replaceTarget, targetPath);
                 }
                 to.waitForBytesWritten(-1);
 
                 qint64 inBytes = from.read(block, Data_Block_Size);
                 to.write(block, inBytes);
+
+                if (m_verifier)
+                    m_verifier->feed(block, inBytes);
+
                 m_bytesCopied += inBytes;
                 m_bytesPerSec += inBytes;
+                m_copiedBytes->add(inBytes);
 
                 if (!m_isInSameDisk){
                     if (m_bytesCopied % (Data_Flush_Size) == 0){
+                        /// a temporary target can't be reopened, it's gone once closed
                         to.flush();
-                        to.close();
-                        if(!to.open(QIODevice::WriteOnly | QIODevice::Append))
-                        {
-                            //Operation failed
-                            qDebug() << tarDir << "isn't write only";
-                            return false;
-                        }
+                        fsync(to.handle());
                     }
                 }
 #endif
@@ -685,12 +918,10 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
                 m_lastMsec = m_timer.elapsed();
                 break;
             case FileJob::Cancelled:
-                from.close();
-                to.close();
+                discardCopy(from, to, isUnnamedTarget);
                 return false;
             default:
-                from.close();
-                to.close();
+                discardCopy(from, to, isUnnamedTarget);
                 return false;
          }
 
@@ -700,6 +931,8 @@ bool FileJob::copyFile(const QString &srcFile, const QString &tarDir, bool isMov
 
 bool FileJob::copyDir(const QString &srcPath, const QString &tarPath, bool isMoved, QString *targetPath)
 {
+    TRACE_SCOPE("FileJob::copyDir");
+
     if(m_applyToAll && m_status == FileJob::Cancelled){
         return false;
     }else if(!m_applyToAll && m_status == FileJob::Cancelled){
@@ -707,6 +940,9 @@ bool FileJob::copyDir(const QString &srcPath, const QString &tarPath, bool isMov
     }
     QDir sourceDir(srcPath);
     QDir targetDir(tarPath + "/" + sourceDir.dirName());
+    const QString originalTarPath = targetDir.absolutePath();
+    /// a move mustn't remove a source that wasn't copied correctly
+    const int verifyFailures = m_verifyFailedFiles.count();
     QFileInfo sf(srcPath);
     QFileInfo tf(tarPath + "/" + sourceDir.dirName());
     m_srcFileName = sf.fileName();
@@ -750,8 +986,15 @@ bool FileJob::copyDir(const QString &srcPath, const QString &tarPath, bool isMov
 
             if(!isTargetDirExists)
             {
-                if(!targetDir.mkdir(m_tarPath))
-                    return false;
+                /// mkdir() takes the name, another writer may have been faster
+                while (::mkdir(QFile::encodeName(m_tarPath).constData(), 0777) != 0) {
+                    if (errno != EEXIST)
+                        return false;
+
+                    m_tarPath = checkDuplicateName(originalTarPath);
+                }
+
+                targetDir.setPath(m_tarPath);
             }
             m_status = Run;
             break;
@@ -762,6 +1005,10 @@ bool FileJob::copyDir(const QString &srcPath, const QString &tarPath, bool isMov
                                       QDir::AllEntries | QDir::System
                                       | QDir::NoDotAndDotDot | QDir::NoSymLinks
                                       | QDir::Hidden);
+            /// the small files of a new directory can't conflict, they are
+            /// copied in batches
+            const bool batched = Use_IO_Uring && !Verify_Copy && !isTargetDirExists && uringBatch();
+            QVector<UringBatch::CopyItem> batch;
 
             while (tmp_iterator.hasNext()) {
                 tmp_iterator.next();
@@ -773,6 +1020,17 @@ bool FileJob::copyDir(const QString &srcPath, const QString &tarPath, bool isMov
                         qDebug() << "coye dir" << fileInfo.filePath() << "failed";
                     }
                 }
+                else if (batched && fileInfo.isFile() && fileInfo.size() <= URING_BATCH_MAX_FILE_SIZE)
+                {
+                    UringBatch::CopyItem item;
+
+                    item.sourcePath = QFile::encodeName(fileInfo.filePath());
+                    item.targetPath = QFile::encodeName(targetDir.absolutePath() + "/" + fileInfo.fileName());
+                    batch << item;
+
+                    if (batch.count() >= URING_COPY_BATCH_SIZE)
+                        copyFileBatch(batch, targetDir.absolutePath());
+                }
                 else
                 {
                     if(!copyFile(fileInfo.filePath(), targetDir.absolutePath()))
@@ -782,10 +1040,13 @@ bool FileJob::copyDir(const QString &srcPath, const QString &tarPath, bool isMov
                 }
             }
 
+            if (!batch.isEmpty())
+                copyFileBatch(batch, targetDir.absolutePath());
+
             if (targetPath)
                 *targetPath = m_tarPath;
 
-            return true;
+            return m_verifyFailedFiles.count() == verifyFailures;
         }
         case Paused:
             QThread::msleep(100);
@@ -850,6 +1111,8 @@ bool FileJob::moveFile(const QString &srcFile, const QString &tarDir, QString *t
             jobConflicted();
         }
 
+    bool replace = false;
+
     while(true)
     {
         switch(m_status)
@@ -862,6 +1125,8 @@ bool FileJob::moveFile(const QString &srcFile, const QString &tarDir, QString *t
                 }
                 else
                 {
+                    replace = true;
+
                     if(!m_applyToAll)
                         m_isReplaced = false;
                     m_srcPath = m_tarPath + "/" + fromInfo.fileName();
@@ -871,20 +1136,29 @@ bool FileJob::moveFile(const QString &srcFile, const QString &tarDir, QString *t
             }
             case FileJob::Run:
             {
-                if(m_isReplaced)
-                {
-                    QFile localFile(to.path() + "/" + fromInfo.fileName());
-                    if(localFile.exists())
-                        localFile.remove();
-
+                const QByteArray &source = QFile::encodeName(from.fileName());
+                int ret;
+
+                /// rename() replaces the target atomically, otherwise the
+                /// name is only taken while it's free
+                if (replace) {
+                    ret = ::rename(source.constData(), QFile::encodeName(m_srcPath).constData());
+                } else {
+                    while ((ret = renameNoReplace(source, QFile::encodeName(m_srcPath))) != 0 && errno == EEXIST) {
+                        m_srcPath = checkDuplicateName(m_tarPath + "/" + fromInfo.fileName());
+                    }
                 }
 
-                bool ok = from.rename(m_srcPath);
+                if (ret != 0) {
+                    qDebug() << "unable to move" << from.fileName() << "to" << m_srcPath << strerror(errno);
 
-                if (ok)
+                    return false;
+                }
+
+                if (targetPath)
                     *targetPath = m_srcPath;
 
-                return ok;
+                return true;
             }
             case FileJob::Paused:
                 QThread::msleep(100);
@@ -1011,6 +1285,8 @@ bool FileJob::moveDir(const QString &srcFile, const QString &tarDir, QString *ta
             jobConflicted();
         }
 
+    bool replace = false;
+
     while(true)
     {
         switch(m_status)
@@ -1023,6 +1299,8 @@ bool FileJob::moveDir(const QString &srcFile, const QString &tarDir, QString *ta
                 }
                 else
                 {
+                    replace = true;
+
                     if(!m_applyToAll)
                         m_isReplaced = false;
                     m_srcPath = m_tarPath + "/" + from.dirName();
@@ -1032,15 +1310,40 @@ bool FileJob::moveDir(const QString &srcFile, const QString &tarDir, QString *ta
             }
             case FileJob::Run:
             {
-                if(m_isReplaced)
+                const QByteArray &source = QFile::encodeName(from.absolutePath());
+                bool ok;
+
+                if(replace)
                 {
-                    QDir localDir(to.path() + "/" + from.dirName());
-                    if(localDir.exists())
-                        localDir.removeRecursively();
+                    /// the replaced directory is swapped out in one step and
+                    /// removed from where the source was
+                    const QFileInfo replacedInfo(m_srcPath);
 
+                    ok = replacedInfo.isDir() && !replacedInfo.isSymLink()
+                            && renameFile(source, QFile::encodeName(m_srcPath), RENAME_EXCHANGE) == 0;
+
+                    if (ok) {
+                        QDir(from.absolutePath()).removeRecursively();
+                    } else {
+                        QDir localDir(to.path() + "/" + from.dirName());
+                        if(localDir.exists())
+                            localDir.removeRecursively();
+
+                        ok = from.rename(from.absolutePath(), m_srcPath);
+                    }
                 }
+                else
+                {
+                    int ret;
 
-                bool ok = from.rename(from.absolutePath(), m_srcPath);
+                    /// a plain rename() would replace an empty directory
+                    while ((ret = renameNoReplace(source, QFile::encodeName(m_srcPath))) != 0
+                           && errno == EEXIST) {
+                        m_srcPath = checkDuplicateName(m_tarPath + "/" + from.dirName());
+                    }
+
+                    ok = ret == 0;
+                }
 
                 if (ok && targetPath)
                     *targetPath = m_srcPath;
@@ -1060,6 +1363,268 @@ bool FileJob::moveDir(const QString &srcFile, const QString &tarDir, QString *ta
     return false;
 }
 
+/// the copy is never written under its name: where the file system has
+/// O_TMPFILE it goes to an unnamed file in the target directory, otherwise to
+/// a hidden one created exclusively beside the target. finishCopy() names it.
+bool FileJob::openTarget(QFile &to, bool *isUnnamed)
+{
+    const QString &tarDir = QFileInfo(m_tarPath).absolutePath();
+    int fd = -1;
+
+#ifdef O_TMPFILE
+    fd = ::open(QFile::encodeName(tarDir).constData(), O_TMPFILE | O_WRONLY | O_CLOEXEC, 0666);
+#endif
+
+    *isUnnamed = fd >= 0;
+
+    QString tempPath;
+    int attempt = 0;
+
+    while (fd < 0) {
+        tempPath = temporaryPath(tarDir, attempt++);
+        fd = ::open(QFile::encodeName(tempPath).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+
+        if (fd < 0 && errno != EEXIST) {
+            qDebug() << tempPath << strerror(errno) << "isn't write only";
+
+            return false;
+        }
+    }
+
+    if (!*isUnnamed)
+        to.setFileName(tempPath);
+
+    if (!to.open(fd, QIODevice::WriteOnly, QFileDevice::AutoCloseHandle)) {
+        qDebug() << m_tarPath << to.errorString() << "isn't write only";
+        ::close(fd);
+
+        if (!*isUnnamed)
+            ::unlink(QFile::encodeName(tempPath).constData());
+
+        return false;
+    }
+
+    return true;
+}
+
+/// the last step of a copy: it's checked if it has to be and the temporary
+/// target gets its name, a broken copy is never seen under it
+bool FileJob::finishCopy(QFile &from, QFile &to, bool isUnnamed, bool replace, QString *targetPath)
+{
+    bool ok = true;
+
+    if (Verify_Copy)
+        ok = verifyCopy(from, isUnnamed ? QFile::decodeName(handlePath(to.handle())) : to.fileName());
+
+    if (ok)
+        ok = isUnnamed ? linkTarget(to, replace) : renameTarget(to, replace);
+
+    if (!ok) {
+        discardCopy(from, to, isUnnamed);
+
+        return false;
+    }
+
+    from.close();
+    to.close();
+
+    if (targetPath)
+        *targetPath = m_tarPath;
+
+    return true;
+}
+
+/// an unnamed target goes away with its handle, a hidden one is removed
+void FileJob::discardCopy(QFile &from, QFile &to, bool isUnnamed)
+{
+    from.close();
+    to.close();
+
+    if (!isUnnamed && ::unlink(QFile::encodeName(to.fileName()).constData()) != 0)
+        qDebug() << "unable to remove" << to.fileName() << strerror(errno);
+}
+
+/// the hidden target replaces the old file in one rename(), or takes a name
+/// that's still free
+bool FileJob::renameTarget(QFile &to, bool replace)
+{
+    const QByteArray &tempPath = QFile::encodeName(to.fileName());
+
+    if (!replace)
+        return takeTargetName(tempPath, false);
+
+    const int ret = ::rename(tempPath.constData(), QFile::encodeName(m_tarPath).constData());
+
+    if (ret != 0)
+        qDebug() << "unable to name the copy" << m_tarPath << strerror(errno);
+
+    return ret == 0;
+}
+
+/// a name taken meanwhile gets the next duplicate name, a name the file
+/// system doesn't take is percent encoded once
+bool FileJob::takeTargetName(const QByteArray &tempPath, bool isUnnamed)
+{
+    const QString &tarDir = QFileInfo(m_tarPath).absolutePath();
+    QString fileName = m_srcFileName;
+    bool isEncoded = false;
+
+    forever {
+        const QByteArray &target = QFile::encodeName(m_tarPath);
+        const int ret = isUnnamed ? ::linkat(AT_FDCWD, tempPath.constData(), AT_FDCWD, target.constData(), AT_SYMLINK_FOLLOW)
+                                  : renameNoReplace(tempPath, target);
+
+        if (ret == 0)
+            return true;
+
+        const int error = errno;
+
+        if (error == EEXIST) {
+            m_tarPath = checkDuplicateName(tarDir + "/" + fileName);
+
+            continue;
+        }
+
+        qDebug() << "unable to name the copy" << m_tarPath << strerror(error);
+
+        if (isEncoded || (error != EINVAL && error != EILSEQ))
+            return false;
+
+        isEncoded = true;
+        fileName = DUrl::toPercentEncoding(m_srcFileName);
+        m_tarPath = tarDir + "/" + fileName;
+        qDebug() << "toPercentEncoding" << m_tarPath;
+    }
+}
+
+/// linkat() doesn't replace: a replaced target is linked beside it under a
+/// temporary name and renamed over it
+bool FileJob::linkTarget(QFile &to, bool replace)
+{
+    const QByteArray &tempPath = handlePath(to.handle());
+
+    if (!replace)
+        return takeTargetName(tempPath, true);
+
+    const QString &tarDir = QFileInfo(m_tarPath).absolutePath();
+    QByteArray linkPath;
+    int attempt = 0;
+    int ret;
+
+    do {
+        linkPath = QFile::encodeName(temporaryPath(tarDir, attempt++));
+        ret = ::linkat(AT_FDCWD, tempPath.constData(), AT_FDCWD, linkPath.constData(), AT_SYMLINK_FOLLOW);
+    } while (ret != 0 && errno == EEXIST);
+
+    if (ret != 0) {
+        qDebug() << "unable to name the copy" << m_tarPath << strerror(errno);
+
+        return false;
+    }
+
+    if (::rename(linkPath.constData(), QFile::encodeName(m_tarPath).constData()) != 0) {
+        qDebug() << "unable to replace" << m_tarPath << strerror(errno);
+        ::unlink(linkPath.constData());
+
+        return false;
+    }
+
+    return true;
+}
+
+/// the source was hashed while it was copied, only the target is read again
+bool FileJob::verifyCopy(QFile &from, const QString &targetFilePath)
+{
+    TRACE_SCOPE("FileJob::verifyCopy");
+
+    quint64 sourceHash = 0;
+    quint64 targetHash = 0;
+
+#ifdef SPLICE_CP
+    /// spliced data never passes through here, but the source is still cached
+    bool ok = CopyVerifier::hashFile(from.handle(), &sourceHash);
+#else
+    bool ok = true;
+
+    sourceHash = m_verifier->finish();
+#endif
+
+    ok = ok && CopyVerifier::hashFileFromDisk(targetFilePath, &targetHash);
+
+    if (ok && sourceHash == targetHash)
+        return true;
+
+    qWarning() << "copy of" << from.fileName() << "to" << m_tarPath << "doesn't match its source";
+
+    m_verifyFailedFiles << m_tarPath;
+    emit error(tr("%1 doesn't match its source after copying").arg(m_tarPath));
+
+    return false;
+}
+
+/// null without io_uring, the callers keep going file by file then
+UringBatch *FileJob::uringBatch()
+{
+    if (!m_uringBatch)
+        m_uringBatch = new UringBatch;
+
+    return m_uringBatch->isValid() ? m_uringBatch : Q_NULLPTR;
+}
+
+/// what the batch didn't copy goes through copyFile, which reports the errors
+void FileJob::copyFileBatch(QVector<UringBatch::CopyItem> &items, const QString &tarDir)
+{
+    TRACE_SCOPE("FileJob::copyFileBatch");
+
+    while (m_status == FileJob::Paused) {
+        QThread::msleep(100);
+        m_lastMsec = m_timer.elapsed();
+    }
+
+    if (m_status == FileJob::Cancelled && m_applyToAll) {
+        items.clear();
+
+        return;
+    }
+
+    m_srcPath = QFile::decodeName(items.first().sourcePath);
+    m_srcFileName = QFileInfo(m_srcPath).fileName();
+    m_uringBatch->copyFiles(items);
+
+    for (const UringBatch::CopyItem &item : items) {
+        if (item.done) {
+            m_bytesCopied += item.size;
+            m_bytesPerSec += item.size;
+            m_copiedBytes->add(item.size);
+        } else if (!copyFile(QFile::decodeName(item.sourcePath), tarDir)) {
+            qDebug() << "coye file" << item.sourcePath << "failed";
+        }
+    }
+
+    items.clear();
+}
+
+void FileJob::deleteFileBatch(QVector<QByteArray> &filePaths)
+{
+    TRACE_SCOPE("FileJob::deleteFileBatch");
+
+    const QVector<bool> &removed = m_uringBatch->removeFiles(filePaths);
+
+    for (int i = 0; i < filePaths.count(); ++i) {
+        if (removed.at(i))
+            continue;
+
+        const QString &filePath = QFile::decodeName(filePaths.at(i));
+
+        if (!deleteFile(filePath)) {
+            emit error("Unable to remove file");
+            qDebug() << "Unable to remove file" << filePath;
+        }
+    }
+
+    filePaths.clear();
+}
+
 bool FileJob::deleteFile(const QString &file)
 {
 #ifdef SW_LABEL
@@ -1072,6 +1637,19 @@ bool FileJob::deleteFile(const QString &file)
     }
 #endif
 
+    const QString &trashInfoPath = TRASHINFOPATH + "/";
+
+    if (file.startsWith(trashInfoPath) && file.endsWith(".trashinfo")
+            && file.indexOf('/', trashInfoPath.size()) < 0) {
+        const QString &fileBaseName = file.mid(trashInfoPath.size(), file.size() - trashInfoPath.size() - 10);
+
+        if (trashInfoCache->removeTrashInfo(fileBaseName))
+            return true;
+
+        qDebug() << "unable to delete file:" << file;
+        return false;
+    }
+
     QFile f(file);
 
     if(f.remove()){
@@ -1087,6 +1665,8 @@ bool FileJob::deleteFile(const QString &file)
 
 bool FileJob::deleteDir(const QString &dir)
 {
+    TRACE_SCOPE("FileJob::deleteDir");
+
     if (m_status == FileJob::Cancelled) {
         emit result("cancelled");
         return false;
@@ -1097,11 +1677,23 @@ bool FileJob::deleteDir(const QString &dir)
     sourceDir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System | QDir::AllDirs);
 
     QDirIterator iterator(sourceDir, QDirIterator::Subdirectories);
+#ifdef SW_LABEL
+    /// every file needs its own privilege check
+    const bool batched = false;
+#else
+    const bool batched = Use_IO_Uring && !dir.startsWith(TRASHINFOPATH) && uringBatch();
+#endif
+    QVector<QByteArray> batch;
 
     while (iterator.hasNext()) {
         const QFileInfo &fileInfo = iterator.next();
 
-        if (fileInfo.isFile() || fileInfo.isSymLink()) {
+        if (batched && (fileInfo.isFile() || fileInfo.isSymLink())) {
+            batch << QFile::encodeName(fileInfo.filePath());
+
+            if (batch.count() >= URING_COPY_BATCH_SIZE)
+                deleteFileBatch(batch);
+        } else if (fileInfo.isFile() || fileInfo.isSymLink()) {
             if (!deleteFile(fileInfo.filePath())) {
                 emit error("Unable to remove file");
                 qDebug() << "Unable to remove file" << fileInfo.filePath();
@@ -1113,6 +1705,9 @@ bool FileJob::deleteDir(const QString &dir)
         }
     }
 
+    if (!batch.isEmpty())
+        deleteFileBatch(batch);
+
     if (!sourceDir.rmdir(QDir::toNativeSeparators(sourceDir.path()))) {
         qDebug() << "Unable to remove dir:" << sourceDir.path();
         emit("Unable to remove dir: " + sourceDir.path());
@@ -1157,30 +1752,7 @@ bool FileJob::moveDirToTrash(const QString &dir, QString *targetPath)
 
 QString FileJob::getNotExistsTrashFileName(const QString &fileName)
 {
-    QByteArray name = fileName.toUtf8();
-
-    int index = name.lastIndexOf('/');
-
-    if (index >= 0)
-        name = name.mid(index + 1);
-
-    index = name.lastIndexOf('.');
-    QByteArray suffix;
-
-    if (index >= 0)
-        suffix = name.mid(index);
-
-    if (suffix.size() > 200)
-        suffix = suffix.left(200);
-
-    name.chop(suffix.size());
-    name = name.left(200 - suffix.size());
-
-    while (QFile::exists(TRASHFILEPATH + "/" + name + suffix)) {
-        name = QCryptographicHash::hash(name, QCryptographicHash::Md5).toHex();
-    }
-
-    return QString::fromUtf8(name + suffix);
+    return trashInfoCache->notExistsTrashFileName(fileName);
 }
 
 bool FileJob::moveFileToTrash(const QString &file, QString *targetPath)
@@ -1217,29 +1789,7 @@ bool FileJob::moveFileToTrash(const QString &file, QString *targetPath)
 
 bool FileJob::writeTrashInfo(const QString &fileBaseName, const QString &path, const QString &time)
 {
-    QFile metadata( m_trashLoc + "/info/" + fileBaseName + ".trashinfo" );
-
-    if (!metadata.open( QIODevice::WriteOnly )) {
-        qDebug() << metadata.fileName() << "file open error:" << metadata.errorString();
-
-        return false;
-    }
-
-    QByteArray data;
-
-    data.append("[Trash Info]\n");
-    data.append("Path=").append(path.toUtf8().toPercentEncoding("/")).append("\n");
-    data.append("DeletionDate=").append(time).append("\n");
-
-    qint64 size = metadata.write(data);
-
-    metadata.close();
-
-    if (size < 0) {
-        qDebug() << "write file " << metadata.fileName() << "error:" << metadata.errorString();
-    }
-
-    return size > 0;
+    return trashInfoCache->writeTrashInfo(fileBaseName, path, time);
 }
 
 #ifdef SW_LABEL
@@ -3,11 +3,17 @@
 
 #include <QObject>
 #include <QMap>
+#include <QStringList>
 #include <QElapsedTimer>
 #include <QUrl>
 #include "../models/durl.h"
+#include "../shutil/uringbatch.h"
 #include <QStorageInfo>
 
+class MetricCounter;
+class CopyVerifier;
+class QFile;
+
 #define TRANSFER_RATE 5
 #define MSEC_FOR_DISPLAY 1000
 #define DATA_BLOCK_SIZE 65536
@@ -34,6 +40,8 @@ public:
     static qint64 Msec_For_Display;
     static qint64 Data_Block_Size;
     static qint64 Data_Flush_Size;
+    static bool Verify_Copy;
+    static bool Use_IO_Uring;
 
     void setStatus(Status status);
     explicit FileJob(const QString &type, QObject *parent = 0);
@@ -78,6 +86,7 @@ public slots:
     void jobAborted();
     void jobPrepared();
     void jobConflicted();
+    void jobVerifyFailed();
 
 private:
     Status m_status;
@@ -101,13 +110,27 @@ private:
     int m_windowId = -1;
     int m_filedes[2] = {0, 0};
     bool m_isInSameDisk = true;
-
+    MetricCounter *m_activeJobs;
+    MetricCounter *m_copiedBytes;
+    CopyVerifier *m_verifier = Q_NULLPTR;
+    QStringList m_verifyFailedFiles;
+    UringBatch *m_uringBatch = Q_NULLPTR;
 
     bool copyFile(const QString &srcFile, const QString &tarDir, bool isMoved=false, QString *targetPath = 0);
     bool copyDir(const QString &srcPath, const QString &tarPath, bool isMoved=false, QString *targetPath = 0);
     bool moveFile(const QString &srcFile, const QString &tarDir, QString *targetPath = 0);
     bool restoreTrashFile(const QString &srcFile, const QString &tarFile);
     bool moveDir(const QString &srcFile, const QString &tarDir, QString *targetPath = 0);
+    bool openTarget(QFile &to, bool *isUnnamed);
+    bool finishCopy(QFile &from, QFile &to, bool isUnnamed, bool replace, QString *targetPath);
+    void discardCopy(QFile &from, QFile &to, bool isUnnamed);
+    bool linkTarget(QFile &to, bool replace);
+    bool renameTarget(QFile &to, bool replace);
+    bool takeTargetName(const QByteArray &tempPath, bool isUnnamed);
+    bool verifyCopy(QFile &from, const QString &targetFilePath);
+    UringBatch *uringBatch();
+    void copyFileBatch(QVector<UringBatch::CopyItem> &items, const QString &tarDir);
+    void deleteFileBatch(QVector<QByteArray> &filePaths);
     bool deleteFile(const QString &file);
     bool deleteDir(const QString &dir);
     bool moveDirToTrash(const QString &dir, QString *targetPath = 0);
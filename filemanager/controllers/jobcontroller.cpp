@@ -1,6 +1,8 @@
 #include "jobcontroller.h"
 #include "fileservices.h"
 
+#include "../app/tracer.h"
+
 #include <QtConcurrent/QtConcurrent>
 
 #ifndef LOAD_FILE_INTERVAL
@@ -85,6 +87,8 @@ void JobController::stopAndDeleteLater()
 
 void JobController::run()
 {
+    TRACE_SCOPE("JobController::run");
+
     if (!m_iterator) {
         emit childrenUpdated(FileServices::instance()->getChildren(m_fileUrl, m_filters));
 
@@ -8,6 +8,11 @@
 #include <QProcess>
 #include <QDir>
 #include "../shutil/standardpath.h"
+#include "../app/global.h"
+
+#include "widgets/singleton.h"
+
+#include "deviceinfo/pathclassifier.h"
 
 PathManager::PathManager(QObject *parent) : QObject(parent)
 {
@@ -74,11 +79,7 @@ QString PathManager::getSystemPathDisplayName(QString key)
 QString PathManager::getSystemPathDisplayNameByPath(const QString &path)
 {
     if (isSystemPath(path)){
-        foreach (QString key, systemPathsMap().keys()) {
-            if (systemPathsMap().value(key) == path){
-                 return getSystemPathDisplayName(key);
-            }
-        }
+        return getSystemPathDisplayName(pathClassifier->classify(path).systemPathKey);
     }
     return QString();
 }
@@ -94,11 +95,7 @@ QString PathManager::getSystemPathIconName(QString key)
 QString PathManager::getSystemPathIconNameByPath(const QString &path)
 {
     if (isSystemPath(path)){
-        foreach (QString key, systemPathsMap().keys()) {
-            if (systemPathsMap().value(key) == path){
-                 return getSystemPathIconName(key);
-            }
-        }
+        return getSystemPathIconName(pathClassifier->classify(path).systemPathKey);
     }
     return QString();
 }
@@ -129,6 +126,8 @@ void PathManager::loadSystemPaths()
         m_fileSystemWatcher->addPath(path);
         m_systemPathsSet << path;
     }
+
+    pathClassifier->setSystemPaths(m_systemPathsMap);
 }
 
 void PathManager::mkPath(const QString &path)
@@ -17,15 +17,65 @@
 #include <QByteArray>
 #include <QDateTime>
 #include <QUrl>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
 
 #define fileService FileServices::instance()
 
+#define RECENT_HISTORY_MAX_COUNT 500
+/// a small history is still folded only every this many records
+#define RECENT_HISTORY_LOG_MIN_COUNT 100
+#define RECENT_HISTORY_SAVE_DELAY 1000
+
 RecentHistoryManager *firstRecent = Q_NULLPTR;
 
+static void appendLogFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Couldn't open recent history log file!";
+        return;
+    }
+
+    file.write(data);
+}
+
+static void writeSnapshotFile(const QString &filePath, const QString &logFilePath, const QByteArray &data)
+{
+    QFile file(filePath + ".tmp");
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Couldn't open recent history file!";
+        return;
+    }
+
+    if (file.write(data) != data.size()) {
+        qDebug() << "Couldn't write recent history file!" << file.errorString();
+        return;
+    }
+
+    file.close();
+
+    QFile::remove(filePath);
+
+    if (file.rename(filePath))
+        QFile::remove(logFilePath);
+}
+
 RecentHistoryManager::RecentHistoryManager(QObject *parent)
     : AbstractFileController(parent)
     , BaseManager()
+    , m_cacheFilePath(cachePath())
+    , m_logFilePath(logPath())
+    , m_saveTimer(new QTimer(this))
 {
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(RECENT_HISTORY_SAVE_DELAY);
+    m_ioPool.setMaxThreadCount(1);
+
+    connect(m_saveTimer, &QTimer::timeout, this, &RecentHistoryManager::flushLog);
+
     if(!firstRecent) {
         firstRecent = this;
 
@@ -42,38 +92,52 @@ RecentHistoryManager::RecentHistoryManager(QObject *parent)
 
 RecentHistoryManager::~RecentHistoryManager()
 {
+    if (m_saveTimer->isActive()) {
+        m_saveTimer->stop();
+        flushLog();
+    }
 
+    m_ioPool.waitForDone();
 }
 
 void RecentHistoryManager::load()
 {
+    m_mutex.lock();
+    m_openedFileList.clear();
+    m_openedFiles.clear();
+    m_fileInfos.clear();
+    m_mutex.unlock();
+    m_logLineCount = 0;
+
     //TODO: check permission and existence of the path
-    QString filePath = cachePath();
-    QFile file(filePath);
+    QFile file(m_cacheFilePath);
     if (!file.open(QIODevice::ReadOnly))
     {
         qDebug() << "Couldn't open recent history file!";
-        return;
+    } else {
+        QByteArray data = file.readAll();
+        QJsonDocument jsonDoc(QJsonDocument::fromJson(data));
+        loadJson(jsonDoc.object());
     }
-    QByteArray data = file.readAll();
-    QJsonDocument jsonDoc(QJsonDocument::fromJson(data));
-    loadJson(jsonDoc.object());
+
+    QFile logFile(m_logFilePath);
+
+    if (logFile.open(QIODevice::ReadOnly))
+        loadLog(logFile.readAll());
 }
 
 void RecentHistoryManager::save()
 {
-    //TODO: check permission and existence of the path
-    QString filePath = cachePath();
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly))
-    {
-        qDebug() << "Couldn't open recent history file!";
-        return;
-    }
     QJsonObject object;
     writeJson(object);
     QJsonDocument jsonDoc(object);
-    file.write(jsonDoc.toJson());
+
+    /// the snapshot covers every change, pending log records are superseded by it
+    m_saveTimer->stop();
+    m_pendingLog.clear();
+    m_logLineCount = 0;
+
+    QtConcurrent::run(&m_ioPool, writeSnapshotFile, m_cacheFilePath, m_logFilePath, jsonDoc.toJson());
 }
 
 bool RecentHistoryManager::openFile(const DUrl &fileUrl, bool &accepted) const
@@ -105,12 +169,21 @@ const QList<AbstractFileInfoPointer> RecentHistoryManager::getChildren(const DUr
 
     accepted = true;
 
+    QMutexLocker locker(&m_mutex);
+
+    infolist.reserve(m_openedFileList.size());
+
     for (const DUrl &url : m_openedFileList) {
-        RecentFileInfo* info =  new RecentFileInfo(url);
-        if (m_lastFileOpenedTime.contains(url)){
-            info->setLastOpened(m_lastFileOpenedTime.value(url));
+        AbstractFileInfoPointer &info = m_fileInfos[url];
+
+        if (!info) {
+            RecentFileInfo *recentInfo = new RecentFileInfo(url);
+
+            recentInfo->setLastOpened(m_openedFiles.value(url).lastOpened);
+            info = AbstractFileInfoPointer(recentInfo);
         }
-        infolist.append(AbstractFileInfoPointer(info));
+
+        infolist.append(info);
     }
 
     return infolist;
@@ -128,46 +201,161 @@ QString RecentHistoryManager::cachePath()
     return getCachePath("recentHistory");
 }
 
+QString RecentHistoryManager::logPath()
+{
+    return QString("%1/%2").arg(StandardPath::getCachePath(), "recentHistory.log");
+}
+
 void RecentHistoryManager::loadJson(const QJsonObject &json)
 {
-    m_openedFileList.clear();
-    m_lastFileOpenedTime.clear();
     QJsonArray jsonArray = json["RecentHistory"].toArray();
     for(int i = 0; i < jsonArray.size(); i++)
     {
         QJsonObject object = jsonArray[i].toObject();
         QString url = object["url"].toString();
-        qint64 mSecsSinceEpoch = object["lastOpened"].toInt();
-        DUrl durl = DUrl(url);
-        m_openedFileList.append(durl);
-        m_lastFileOpenedTime.insert(durl, QDateTime::fromMSecsSinceEpoch(mSecsSinceEpoch));
+        qint64 mSecsSinceEpoch = object["lastOpened"].toVariant().toLongLong();
+        touchFile(DUrl(url), QDateTime::fromMSecsSinceEpoch(mSecsSinceEpoch));
     }
 }
 
 void RecentHistoryManager::writeJson(QJsonObject &json)
 {
     QJsonArray localArray;
-    for(int i = 0; i < m_openedFileList.size(); i++)
-    {
+
+    /// written oldest first, so that loading it back keeps the recency order
+    for (auto it = m_openedFileList.constEnd(); it != m_openedFileList.constBegin();) {
+        --it;
+
         QJsonObject object;
-        object["url"] = m_openedFileList.at(i).toString();
-        if (m_lastFileOpenedTime.contains(m_openedFileList.at(i))){
-            object["lastOpened"] = m_lastFileOpenedTime.value(m_openedFileList.at(i)).toMSecsSinceEpoch();
-        }
+        object["url"] = it->toString();
+        object["lastOpened"] = m_openedFiles.value(*it).lastOpened.toMSecsSinceEpoch();
         localArray.append(object);
     }
     json["RecentHistory"] = localArray;
 }
 
+void RecentHistoryManager::loadLog(const QByteArray &data)
+{
+    /// One record per line:
+    /// "+ <msecs since epoch> <percent encoded path>": file opened
+    /// "- <percent encoded path>": file removed
+    for (const QByteArray &line : data.split('\n')) {
+        if (line.isEmpty())
+            continue;
+
+        ++m_logLineCount;
+
+        if (line.startsWith("+ ")) {
+            int index = line.indexOf(' ', 2);
+
+            if (index < 0)
+                continue;
+
+            qint64 mSecsSinceEpoch = line.mid(2, index - 2).toLongLong();
+            const QString &path = QString::fromUtf8(QByteArray::fromPercentEncoding(line.mid(index + 1)));
+
+            touchFile(DUrl::fromRecentFile(path), QDateTime::fromMSecsSinceEpoch(mSecsSinceEpoch));
+        } else if (line.startsWith("- ")) {
+            const QString &path = QString::fromUtf8(QByteArray::fromPercentEncoding(line.mid(2)));
+
+            forgetFile(DUrl::fromRecentFile(path));
+        }
+    }
+}
+
+bool RecentHistoryManager::touchFile(const DUrl &url, const QDateTime &lastOpened, DUrlList *evictedList)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_openedFiles.find(url);
+
+    if (it != m_openedFiles.end()) {
+        m_openedFileList.erase(it->position);
+        it->position = m_openedFileList.insert(m_openedFileList.begin(), url);
+        it->lastOpened = lastOpened;
+
+        const AbstractFileInfoPointer &info = m_fileInfos.value(url);
+
+        if (info)
+            static_cast<RecentFileInfo*>(info.data())->setLastOpened(lastOpened);
+
+        return false;
+    }
+
+    RecentEntry entry;
+
+    entry.position = m_openedFileList.insert(m_openedFileList.begin(), url);
+    entry.lastOpened = lastOpened;
+    m_openedFiles.insert(url, entry);
+
+    while (m_openedFileList.size() > RECENT_HISTORY_MAX_COUNT) {
+        const DUrl evictedUrl = m_openedFileList.takeLast();
+
+        m_openedFiles.remove(evictedUrl);
+        m_fileInfos.remove(evictedUrl);
+
+        if (evictedList)
+            evictedList->append(evictedUrl);
+    }
+
+    return true;
+}
+
+bool RecentHistoryManager::forgetFile(const DUrl &url)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_openedFiles.find(url);
+
+    if (it == m_openedFiles.end())
+        return false;
+
+    m_openedFileList.erase(it->position);
+    m_openedFiles.erase(it);
+    m_fileInfos.remove(url);
+
+    return true;
+}
+
+void RecentHistoryManager::appendLog(const QByteArray &line)
+{
+    m_pendingLog.append(line).append('\n');
+
+    if (!m_saveTimer->isActive())
+        m_saveTimer->start();
+}
+
+void RecentHistoryManager::flushLog()
+{
+    if (m_pendingLog.isEmpty())
+        return;
+
+    m_logLineCount += m_pendingLog.count('\n');
+
+    /// fold the log into the snapshot once it holds more records than the
+    /// history itself, so it never grows without bound and the cost of the
+    /// rewrite is spread over as many records as it writes
+    if (m_logLineCount > qMax(m_openedFileList.size(), RECENT_HISTORY_LOG_MIN_COUNT)) {
+        save();
+
+        return;
+    }
+
+    QtConcurrent::run(&m_ioPool, appendLogFile, m_logFilePath, m_pendingLog);
+
+    m_pendingLog.clear();
+}
+
 void RecentHistoryManager::removeRecentFiles(const DUrlList &urlList)
 {
     for(const DUrl &url : urlList) {
-        m_openedFileList.removeOne(url);
-        m_lastFileOpenedTime.remove(url);
+        if (!forgetFile(url))
+            continue;
+
+        appendLog("- " + url.path().toUtf8().toPercentEncoding("/"));
+
         emit childrenRemoved(url);
     }
-
-    save();
 }
 
 void RecentHistoryManager::clearRecentFiles()
@@ -176,8 +364,12 @@ void RecentHistoryManager::clearRecentFiles()
         emit childrenRemoved(url);
     }
 
+    m_mutex.lock();
     m_openedFileList.clear();
-    m_lastFileOpenedTime.clear();
+    m_openedFiles.clear();
+    m_fileInfos.clear();
+    m_mutex.unlock();
+
     save();
 }
 
@@ -187,16 +379,18 @@ void RecentHistoryManager::addOpenedFile(const DUrl &url)
         return;
 
     DUrl recent_url = DUrl::fromRecentFile(url.path());
+    const QDateTime &lastOpened = QDateTime::currentDateTime();
+    DUrlList evictedList;
 
-    m_lastFileOpenedTime.insert(recent_url, QDateTime::currentDateTime());
-
-    if(m_openedFileList.contains(recent_url))
-        return;
+    bool added = touchFile(recent_url, lastOpened, &evictedList);
 
-    m_openedFileList << recent_url;
+    appendLog("+ " + QByteArray::number(lastOpened.toMSecsSinceEpoch())
+              + " " + url.path().toUtf8().toPercentEncoding("/"));
 
-    emit childrenAdded(recent_url);
+    for (const DUrl &evictedUrl : evictedList) {
+        emit childrenRemoved(evictedUrl);
+    }
 
-    save();
+    if (added)
+        emit childrenAdded(recent_url);
 }
-
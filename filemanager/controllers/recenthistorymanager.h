@@ -3,13 +3,21 @@
 
 #include <QList>
 #include <QDir>
-#include <QMap>
+#include <QHash>
+#include <QLinkedList>
+#include <QDateTime>
+#include <QThreadPool>
+#include <QMutex>
 
 #include "basemanager.h"
 #include "abstractfilecontroller.h"
 
 class AbstractFileInfo;
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 class RecentHistoryManager : public AbstractFileController, public BaseManager
 {
     Q_OBJECT
@@ -26,20 +34,46 @@ public:
     const AbstractFileInfoPointer createFileInfo(const DUrl &fileUrl, bool &accepted) const Q_DECL_OVERRIDE;
 
     static QString cachePath();
+    static QString logPath();
 
 private:
+    struct RecentEntry
+    {
+        QLinkedList<DUrl>::iterator position;
+        QDateTime lastOpened;
+    };
+
     void loadJson(const QJsonObject &json);
     void writeJson(QJsonObject &json);
+    void loadLog(const QByteArray &data);
+
+    bool touchFile(const DUrl &url, const QDateTime &lastOpened, DUrlList *evictedList = 0);
+    bool forgetFile(const DUrl &url);
+
+    void appendLog(const QByteArray &line);
 
     void removeRecentFiles(const DUrlList &urlList);
     void clearRecentFiles();
 
 private slots:
     void addOpenedFile(const DUrl &url);
+    void flushLog();
 
 private:
-    QList<DUrl> m_openedFileList;
-    QMap<DUrl, QDateTime> m_lastFileOpenedTime;
+    /// most recently opened first
+    QLinkedList<DUrl> m_openedFileList;
+    QHash<DUrl, RecentEntry> m_openedFiles;
+    mutable QHash<DUrl, AbstractFileInfoPointer> m_fileInfos;
+    /// getChildren() runs on the job threads, the three containers above are
+    /// changed on the GUI thread under this lock and read there without it
+    mutable QMutex m_mutex;
+
+    QString m_cacheFilePath;
+    QString m_logFilePath;
+    QByteArray m_pendingLog;
+    int m_logLineCount = 0;
+    QTimer *m_saveTimer;
+    QThreadPool m_ioPool;
 };
 
 #endif // RECENTHISTORYMANAGER_H
@@ -7,9 +7,19 @@
 #include "../app/global.h"
 #include "../app/filesignalmanager.h"
 
+#include "../shutil/contentsearchengine.h"
+#include "../shutil/filenamematcher.h"
+
 #include <QDebug>
-#include <QRegularExpression>
 #include <QQueue>
+#include <QScopedPointer>
+#include <QHash>
+#include <QFile>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
 
 class SearchDiriterator : public DDirIterator
 {
@@ -27,6 +37,10 @@ public:
     void close() Q_DECL_OVERRIDE;
 
 private:
+    void appendResult(const DUrl &realUrl) const;
+    bool hasNextContent() const;
+    bool hasNextLocal() const;
+
     SearchController *parent;
     AbstractFileInfoPointer currentFileInfo;
     mutable QQueue<DUrl> childrens;
@@ -34,12 +48,21 @@ private:
     DUrl fileUrl;
     DUrl targetUrl;
     QString keyword;
-    QRegularExpression regular;
+    FileNameMatcher matcher;
     QDir::Filters m_filter;
     QDirIterator::IteratorFlags m_flags;
     mutable QList<DUrl> searchPathList;
     mutable DDirIteratorPointer it;
 
+    /// local folders are read with readdir, names are matched as raw bytes
+    mutable QList<QByteArray> localPathList;
+    mutable QByteArray localDirPath;
+    mutable DIR *localDir = Q_NULLPTR;
+
+    bool contentSearch;
+    mutable QScopedPointer<ContentSearchEngine> contentEngine;
+    mutable QHash<DUrl, QString> snippets;
+
     bool closed = false;
 };
 
@@ -47,17 +70,25 @@ SearchDiriterator::SearchDiriterator(const DUrl &url, QDir::Filters filter, QDir
     : DDirIterator()
     , parent(parent)
     , fileUrl(url)
+    , targetUrl(url.searchTargetUrl())
+    , keyword(url.searchKeyword())
+    , matcher(keyword)
     , m_filter(filter)
     , m_flags(flags)
 {
-    targetUrl = url.searchTargetUrl();
-    keyword = url.searchKeyword();
-    regular = QRegularExpression(QRegularExpression::escape((keyword)), QRegularExpression::CaseInsensitiveOption);
-    searchPathList << targetUrl;
+    contentSearch = url.searchContent() && targetUrl.isLocalFile();
+
+    if (targetUrl.isLocalFile())
+        localPathList << QFile::encodeName(targetUrl.toLocalFile());
+    else
+        searchPathList << targetUrl;
 }
 
 SearchDiriterator::~SearchDiriterator()
 {
+    if (localDir)
+        ::closedir(localDir);
+
     parent->removeJob(targetUrl);
 }
 
@@ -69,6 +100,9 @@ DUrl SearchDiriterator::next()
 
         currentFileInfo = parent->createFileInfo(url, accpeted);
 
+        if (contentSearch)
+            static_cast<SearchFileInfo*>(currentFileInfo.data())->setMatchSnippet(snippets.take(url));
+
         return url;
     }
 
@@ -80,6 +114,12 @@ bool SearchDiriterator::hasNext() const
     if (!childrens.isEmpty())
         return true;
 
+    if (contentSearch)
+        return hasNextContent();
+
+    if (targetUrl.isLocalFile())
+        return hasNextLocal();
+
     forever {
         if (closed)
             return false;
@@ -114,22 +154,8 @@ bool SearchDiriterator::hasNext() const
                     searchPathList << url;
             }
 
-            if (fileInfo->fileName().indexOf(regular) >= 0) {
-                DUrl url = fileUrl;
-                const DUrl &realUrl = fileInfo->fileUrl();
-
-                url.setSearchedFileUrl(realUrl);
-
-                if (parent->urlToTargetUrlMap.contains(realUrl, fileUrl)) {
-                    ++parent->urlToTargetUrlMapInsertCount[QPair<DUrl, DUrl>(realUrl, fileUrl)];
-                } else {
-                    parent->urlToTargetUrlMap.insertMulti(realUrl, fileUrl);
-                    parent->urlToTargetUrlMapInsertCount[QPair<DUrl, DUrl>(realUrl, fileUrl)] = 0;
-                }
-
-                fileService->addUrlMonitor(realUrl);
-
-                childrens << url;
+            if (matcher.match(fileInfo->fileName())) {
+                appendResult(fileInfo->fileUrl());
 
                 return true;
             }
@@ -164,6 +190,117 @@ QString SearchDiriterator::path() const
 void SearchDiriterator::close()
 {
     closed = true;
+
+    if (contentEngine)
+        contentEngine->stop();
+}
+
+void SearchDiriterator::appendResult(const DUrl &realUrl) const
+{
+    DUrl url = fileUrl;
+
+    url.setSearchedFileUrl(realUrl);
+
+    if (parent->urlToTargetUrlMap.contains(realUrl, fileUrl)) {
+        ++parent->urlToTargetUrlMapInsertCount[QPair<DUrl, DUrl>(realUrl, fileUrl)];
+    } else {
+        parent->urlToTargetUrlMap.insertMulti(realUrl, fileUrl);
+        parent->urlToTargetUrlMapInsertCount[QPair<DUrl, DUrl>(realUrl, fileUrl)] = 0;
+    }
+
+    fileService->addUrlMonitor(realUrl);
+
+    childrens << url;
+}
+
+/// breadth first like the generic walk, but without a file info per entry;
+/// links are matched but not followed
+bool SearchDiriterator::hasNextLocal() const
+{
+    forever {
+        if (closed)
+            return false;
+
+        if (!localDir) {
+            if (localPathList.isEmpty())
+                return false;
+
+            localDirPath = localPathList.takeFirst();
+            localDir = ::opendir(localDirPath.constData());
+
+            if (!localDir)
+                continue;
+
+            if (!localDirPath.endsWith('/'))
+                localDirPath.append('/');
+        }
+
+        while (struct dirent *entry = ::readdir(localDir)) {
+            if (closed)
+                return false;
+
+            const char *name = entry->d_name;
+
+            if (name[0] == '.') {
+                if (name[1] == '\0' || (name[1] == '.' && name[2] == '\0') || !m_filter.testFlag(QDir::Hidden))
+                    continue;
+            }
+
+            const QByteArray &path = localDirPath + name;
+            unsigned char type = entry->d_type;
+
+            if (type == DT_UNKNOWN) {
+                struct stat st;
+
+                if (::fstatat(::dirfd(localDir), name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode))
+                    type = DT_DIR;
+            }
+
+            if (type == DT_DIR)
+                localPathList << path;
+
+            if (matcher.match(name, ::strlen(name))) {
+                appendResult(DUrl::fromLocalFile(QFile::decodeName(path)));
+
+                return true;
+            }
+        }
+
+        ::closedir(localDir);
+        localDir = Q_NULLPTR;
+    }
+}
+
+/// the engine walks and scans on its own pool, this only hands on its hits
+bool SearchDiriterator::hasNextContent() const
+{
+    if (closed)
+        return false;
+
+    if (!contentEngine) {
+        contentEngine.reset(new ContentSearchEngine(keyword, m_filter.testFlag(QDir::Hidden)));
+        contentEngine->start(targetUrl.toLocalFile());
+
+        /// close() may have run on the other thread meanwhile
+        if (closed)
+            contentEngine->stop();
+    }
+
+    ContentSearchEngine::Hit hit;
+
+    if (!contentEngine->takeHit(&hit))
+        return false;
+
+    const DUrl &realUrl = DUrl::fromLocalFile(hit.filePath);
+
+    appendResult(realUrl);
+
+    DUrl url = fileUrl;
+
+    url.setSearchedFileUrl(realUrl);
+    snippets[url] = hit.snippet;
+
+    return true;
 }
 
 SearchController::SearchController(QObject *parent)
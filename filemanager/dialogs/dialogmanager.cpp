@@ -109,6 +109,8 @@ void DialogManager::initConnect()
     connect(fileSignalManager, &FileSignalManager::requestShowDevicePropertyDialog, this, &DialogManager::showDevicePropertyDialog);
     connect(fileSignalManager, &FileSignalManager::showDiskErrorDialog,
             this, &DialogManager::showDiskErrorDialog);
+    connect(fileSignalManager, &FileSignalManager::jobVerifyFailed,
+            this, &DialogManager::showVerifyFailedDialog);
     connect(fileSignalManager, &FileSignalManager::showAboutDialog,
             this, &DialogManager::showAboutDialog);
 
@@ -422,6 +424,18 @@ void DialogManager::showDiskErrorDialog(const QString & id, const QString & erro
     }
 }
 
+void DialogManager::showVerifyFailedDialog(const QMap<QString, QString> &jobDetail, const QStringList &filePaths)
+{
+    Q_UNUSED(jobDetail)
+
+    if (filePaths.count() == 1)
+        showMessageDialog(3, tr("%1 doesn't match its source after copying and has been removed")
+                          .arg(QFileInfo(filePaths.first()).fileName()));
+    else
+        showMessageDialog(3, tr("%1 files don't match their sources after copying and have been removed")
+                          .arg(filePaths.count()));
+}
+
 void DialogManager::showBreakSymlinkDialog(const QString &targetName, const DUrl &linkfile)
 {
     const AbstractFileInfoPointer &fileInfo = FileServices::instance()->createFileInfo(linkfile);
@@ -48,6 +48,7 @@ public slots:
     void showTrashPropertyDialog(const FMEvent &event);
     void showDevicePropertyDialog(const FMEvent &event);
     void showDiskErrorDialog(const QString &id, const QString &errorText);
+    void showVerifyFailedDialog(const QMap<QString, QString> &jobDetail, const QStringList &filePaths);
     void showBreakSymlinkDialog(const QString &targetName, const DUrl& linkfile);
     void showAboutDialog(const FMEvent &event);
 
@@ -251,7 +251,7 @@ PropertyDialog::PropertyDialog(const DUrl &url, QWidget* parent)
             m_size = fileInfo->size();
         }else if (fileInfo->isDir()){
             startComputerFolderSize(m_url);
-            m_fileCount = fileInfo->size();
+            m_fileCount = fileInfo->filesCount();
         }
     }
     initTextShowFrame(m_edit->toPlainText());
@@ -356,6 +356,7 @@ void PropertyDialog::startComputerFolderSize(const DUrl &url)
 
     connect(workerThread, &QThread::finished, worker, &FilesSizeWorker::deleteLater);
     connect(workerThread, &QThread::finished, workerThread, &QThread::deleteLater);
+    connect(worker, &FilesSizeWorker::finished, workerThread, &QThread::quit);
 
     connect(this, &PropertyDialog::requestStartComputerFolderSize, worker, &FilesSizeWorker::coumpueteSize);
     connect(worker, &FilesSizeWorker::sizeUpdated, this, &PropertyDialog::updateFolderSize);
@@ -71,6 +71,7 @@ void TrashPropertyDialog::startComputerFolderSize(const DUrl &url)
 
     connect(workerThread, &QThread::finished, worker, &FilesSizeWorker::deleteLater);
     connect(workerThread, &QThread::finished, workerThread, &QThread::deleteLater);
+    connect(worker, &FilesSizeWorker::finished, workerThread, &QThread::quit);
 
     connect(this, &TrashPropertyDialog::requestStartComputerFolderSize, worker, &FilesSizeWorker::coumpueteSize);
     connect(worker, &FilesSizeWorker::sizeUpdated, this, &TrashPropertyDialog::updateFolderSize);
@@ -0,0 +1,222 @@
+HEADERS += \
+    $$PWD/app/define.h \
+    $$PWD/app/global.h \
+    $$PWD/controllers/appcontroller.h \
+    $$PWD/app/filemanagerapp.h \
+    $$PWD/views/dmovablemainwindow.h \
+    $$PWD/views/dleftsidebar.h \
+    $$PWD/views/dtoolbar.h \
+    $$PWD/views/dfileview.h \
+    $$PWD/views/ddetailview.h \
+    $$PWD/views/dicontextbutton.h \
+    $$PWD/views/dstatebutton.h \
+    $$PWD/views/dcheckablebutton.h \
+    $$PWD/models/dfilesystemmodel.h \
+    $$PWD/models/directorysnapshotcache.h \
+    $$PWD/controllers/filecontroller.h \
+    $$PWD/app/filesignalmanager.h \
+    $$PWD/views/fileitem.h \
+    $$PWD/views/filemenumanager.h \
+    $$PWD/views/dsearchbar.h \
+    $$PWD/views/dfileitemdelegate.h \
+    $$PWD/models/fileinfo.h \
+    $$PWD/models/filesortkeys.h \
+    $$PWD/models/desktopfileinfo.h \
+    $$PWD/shutil/iconprovider.h \
+    $$PWD/models/bookmark.h \
+    $$PWD/models/imagefileinfo.h \
+    $$PWD/models/searchhistory.h \
+    $$PWD/models/fmsetting.h \
+    $$PWD/models/fmstate.h \
+    $$PWD/controllers/bookmarkmanager.h \
+    $$PWD/controllers/recenthistorymanager.h \
+    $$PWD/controllers/fmstatemanager.h \
+    $$PWD/controllers/basemanager.h \
+    $$PWD/dialogs/dialogmanager.h \
+    $$PWD/controllers/searchhistroymanager.h \
+    $$PWD/views/windowmanager.h \
+    $$PWD/shutil/desktopfile.h \
+    $$PWD/shutil/fileutils.h \
+    $$PWD/shutil/properties.h \
+    $$PWD/views/dfilemanagerwindow.h \
+    $$PWD/views/dcrumbwidget.h \
+    $$PWD/views/dcrumbbutton.h \
+    $$PWD/views/dhorizseparator.h \
+    $$PWD/app/fmevent.h \
+    $$PWD/views/historystack.h \
+    $$PWD/dialogs/propertydialog.h \
+    $$PWD/controllers/filejob.h \
+    $$PWD/views/dfilemenu.h \
+    $$PWD/views/dhoverbutton.h \
+    $$PWD/views/dbookmarkscene.h \
+    $$PWD/views/dbookmarkitem.h \
+    $$PWD/views/dbookmarkitemgroup.h \
+    $$PWD/views/dbookmarkrootitem.h \
+    $$PWD/views/dbookmarkview.h \
+    $$PWD/controllers/trashmanager.h \
+    $$PWD/views/dsplitter.h \
+    $$PWD/models/abstractfileinfo.h \
+    $$PWD/controllers/fileservices.h \
+    $$PWD/controllers/abstractfilecontroller.h \
+    $$PWD/models/recentfileinfo.h \
+    $$PWD/app/singleapplication.h \
+    $$PWD/app/logutil.h \
+    $$PWD/app/tracer.h \
+    $$PWD/app/metrics.h \
+    $$PWD/app/startupmanager.h \
+    $$PWD/models/trashfileinfo.h \
+    $$PWD/shutil/mimesappsmanager.h \
+    $$PWD/views/dbookmarkline.h \
+    $$PWD/views/dsplitterhandle.h \
+    $$PWD/dialogs/openwithdialog.h \
+    $$PWD/models/durl.h \
+    $$PWD/controllers/searchcontroller.h \
+    $$PWD/models/searchfileinfo.h \
+    $$PWD/shutil/standardpath.h \
+    $$PWD/dialogs/basedialog.h \
+    $$PWD/models/ddiriterator.h \
+    $$PWD/views/extendview.h \
+    $$PWD/controllers/pathmanager.h \
+    $$PWD/views/ddragwidget.h \
+    $$PWD/shutil/mimetypedisplaymanager.h \
+    $$PWD/views/dstatusbar.h \
+    $$PWD/controllers/subscriber.h \
+    $$PWD/shutil/thumbnailmanager.h \
+    $$PWD/models/menuactiontype.h \
+    $$PWD/models/dfileselectionmodel.h \
+    $$PWD/dialogs/closealldialogindicator.h \
+    $$PWD/gvfs/gvfsmountclient.h \
+    $$PWD/gvfs/mountaskpassworddialog.h \
+    $$PWD/gvfs/networkmanager.h \
+    $$PWD/gvfs/secrectmanager.h \
+    $$PWD/models/networkfileinfo.h \
+    $$PWD/controllers/networkcontroller.h \
+    $$PWD/dialogs/openwithotherdialog.h \
+    $$PWD/dialogs/trashpropertydialog.h \
+    $$PWD/views/dbookmarkmountedindicatoritem.h \
+    $$PWD/views/deditorwidgetmenu.h \
+    $$PWD/controllers/jobcontroller.h \
+    $$PWD/shutil/filessizeworker.h \
+    $$PWD/shutil/dirsizeengine.h \
+    $$PWD/views/computerview.h \
+    $$PWD/views/flowlayout.h \
+    $$PWD/shutil/shortcut.h \
+    $$PWD/shutil/trashinfocache.h \
+    $$PWD/shutil/emblemmanager.h \
+    $$PWD/shutil/childcountmanager.h \
+    $$PWD/shutil/contentsearchengine.h \
+    $$PWD/shutil/filenamematcher.h \
+    $$PWD/shutil/copyverifier.h \
+    $$PWD/shutil/uringbatch.h \
+    $$PWD/shutil/pathcompletionengine.h
+
+SOURCES += \
+    $$PWD/controllers/appcontroller.cpp \
+    $$PWD/app/filemanagerapp.cpp \
+    $$PWD/views/dmovablemainwindow.cpp \
+    $$PWD/views/dleftsidebar.cpp \
+    $$PWD/views/dtoolbar.cpp \
+    $$PWD/views/dfileview.cpp \
+    $$PWD/views/ddetailview.cpp \
+    $$PWD/views/dicontextbutton.cpp \
+    $$PWD/views/dstatebutton.cpp \
+    $$PWD/views/dcheckablebutton.cpp \
+    $$PWD/models/dfilesystemmodel.cpp \
+    $$PWD/models/directorysnapshotcache.cpp \
+    $$PWD/controllers/filecontroller.cpp \
+    $$PWD/views/fileitem.cpp \
+    $$PWD/views/filemenumanager.cpp \
+    $$PWD/views/dsearchbar.cpp \
+    $$PWD/views/dfileitemdelegate.cpp \
+    $$PWD/models/fileinfo.cpp \
+    $$PWD/models/filesortkeys.cpp \
+    $$PWD/models/desktopfileinfo.cpp \
+    $$PWD/shutil/iconprovider.cpp \
+    $$PWD/models/bookmark.cpp \
+    $$PWD/models/imagefileinfo.cpp \
+    $$PWD/models/searchhistory.cpp \
+    $$PWD/models/fmsetting.cpp \
+    $$PWD/models/fmstate.cpp \
+    $$PWD/controllers/bookmarkmanager.cpp \
+    $$PWD/controllers/recenthistorymanager.cpp \
+    $$PWD/controllers/fmstatemanager.cpp \
+    $$PWD/controllers/basemanager.cpp \
+    $$PWD/dialogs/dialogmanager.cpp \
+    $$PWD/controllers/searchhistroymanager.cpp \
+    $$PWD/views/windowmanager.cpp \
+    $$PWD/shutil/desktopfile.cpp \
+    $$PWD/shutil/fileutils.cpp \
+    $$PWD/shutil/properties.cpp \
+    $$PWD/views/dfilemanagerwindow.cpp \
+    $$PWD/views/dcrumbwidget.cpp \
+    $$PWD/views/dcrumbbutton.cpp \
+    $$PWD/views/dhorizseparator.cpp \
+    $$PWD/app/fmevent.cpp \
+    $$PWD/views/historystack.cpp \
+    $$PWD/dialogs/propertydialog.cpp \
+    $$PWD/controllers/filejob.cpp \
+    $$PWD/views/dfilemenu.cpp \
+    $$PWD/views/dhoverbutton.cpp \
+    $$PWD/views/dbookmarkscene.cpp \
+    $$PWD/views/dbookmarkitem.cpp \
+    $$PWD/views/dbookmarkitemgroup.cpp \
+    $$PWD/views/dbookmarkrootitem.cpp \
+    $$PWD/views/dbookmarkview.cpp \
+    $$PWD/controllers/trashmanager.cpp \
+    $$PWD/views/dsplitter.cpp \
+    $$PWD/models/abstractfileinfo.cpp \
+    $$PWD/controllers/fileservices.cpp \
+    $$PWD/controllers/abstractfilecontroller.cpp \
+    $$PWD/models/recentfileinfo.cpp \
+    $$PWD/app/singleapplication.cpp \
+    $$PWD/app/logutil.cpp \
+    $$PWD/app/tracer.cpp \
+    $$PWD/app/metrics.cpp \
+    $$PWD/app/startupmanager.cpp \
+    $$PWD/models/trashfileinfo.cpp \
+    $$PWD/shutil/mimesappsmanager.cpp \
+    $$PWD/views/dbookmarkline.cpp \
+    $$PWD/views/dsplitterhandle.cpp \
+    $$PWD/dialogs/openwithdialog.cpp \
+    $$PWD/models/durl.cpp \
+    $$PWD/controllers/searchcontroller.cpp \
+    $$PWD/models/searchfileinfo.cpp \
+    $$PWD/shutil/standardpath.cpp \
+    $$PWD/dialogs/basedialog.cpp \
+    $$PWD/views/extendview.cpp \
+    $$PWD/controllers/pathmanager.cpp \
+    $$PWD/views/ddragwidget.cpp \
+    $$PWD/shutil/mimetypedisplaymanager.cpp \
+    $$PWD/views/dstatusbar.cpp \
+    $$PWD/controllers/subscriber.cpp \
+    $$PWD/shutil/thumbnailmanager.cpp \
+    $$PWD/models/menuactiontype.cpp \
+    $$PWD/models/dfileselectionmodel.cpp \
+    $$PWD/dialogs/closealldialogindicator.cpp \
+    $$PWD/app/global.cpp \
+    $$PWD/gvfs/gvfsmountclient.cpp \
+    $$PWD/gvfs/mountaskpassworddialog.cpp \
+    $$PWD/gvfs/networkmanager.cpp \
+    $$PWD/gvfs/secrectmanager.cpp \
+    $$PWD/models/networkfileinfo.cpp \
+    $$PWD/controllers/networkcontroller.cpp \
+    $$PWD/dialogs/openwithotherdialog.cpp \
+    $$PWD/dialogs/trashpropertydialog.cpp \
+    $$PWD/views/dbookmarkmountedindicatoritem.cpp \
+    $$PWD/views/deditorwidgetmenu.cpp \
+    $$PWD/controllers/jobcontroller.cpp \
+    $$PWD/shutil/filessizeworker.cpp \
+    $$PWD/shutil/dirsizeengine.cpp \
+    $$PWD/views/computerview.cpp \
+    $$PWD/views/flowlayout.cpp \
+    $$PWD/shutil/shortcut.cpp \
+    $$PWD/shutil/trashinfocache.cpp \
+    $$PWD/shutil/emblemmanager.cpp \
+    $$PWD/shutil/childcountmanager.cpp \
+    $$PWD/shutil/contentsearchengine.cpp \
+    $$PWD/shutil/filenamematcher.cpp \
+    $$PWD/shutil/copyverifier.cpp \
+    $$PWD/shutil/uringbatch.cpp \
+    $$PWD/shutil/pathcompletionengine.cpp
+
+INCLUDEPATH += $$PWD/models
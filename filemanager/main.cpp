@@ -4,6 +4,8 @@
 #include "app/logutil.h"
 #include "app/filemanagerapp.h"
 #include "app/singleapplication.h"
+#include "app/tracer.h"
+#include "app/startupmanager.h"
 
 #include "widgets/commandlinemanager.h"
 
@@ -40,6 +42,8 @@ DWIDGET_USE_NAMESPACE
 
 int main(int argc, char *argv[])
 {
+    StartupManager::instance();
+
     Q_INIT_RESOURCE(icons);
     Q_INIT_RESOURCE(dui_theme_dark);
     Q_INIT_RESOURCE(dui_theme_light);
@@ -54,8 +58,13 @@ int main(int argc, char *argv[])
 
     LogUtil::registerLogger();
 
+    StartupManager::instance()->mark("application");
+
     CommandLineManager::instance()->process();
 
+    if (CommandLineManager::instance()->isSet("trace"))
+        Tracer::instance()->start(CommandLineManager::instance()->value("trace"));
+
     DUrl commandlineUrl;
     if (CommandLineManager::instance()->positionalArguments().count() > 0){
         commandlineUrl = DUrl::fromUserInput(CommandLineManager::instance()->positionalArguments().at(0));
@@ -65,12 +74,19 @@ int main(int argc, char *argv[])
 
     QString uniqueKey = app.applicationName();
 
+    if (CommandLineManager::instance()->isSet("metrics"))
+        return SingleApplication::printMetrics(uniqueKey) ? 0 : 1;
+
     bool isSingleInstance  = app.setSingleInstance(uniqueKey);
     bool isBackendRun = CommandLineManager::instance()->isSet("d");
 
     qDebug() << isSingleInstance << commandlineUrl;
 
+    StartupManager::instance()->mark("single instance");
+
     if (isSingleInstance){
+        Tracer::instance()->installSignalHandler();
+
         QTranslator translator;
 
         if (translator.load(APPSHAREDIR"/translations/" + app.applicationName() +"_" + QLocale::system().name()))
@@ -80,35 +96,61 @@ int main(int argc, char *argv[])
 
         app.setApplicationDisplayName(QObject::tr("Deepin File Manager"));
 
+        QTranslator translator_qt;
+        if (translator_qt.load(QLibraryInfo::location(QLibraryInfo::TranslationsPath) + "/qt_" + QLocale::system().name() + ".qm"))
+            app.installTranslator(&translator_qt);
+
+        QThreadPool::globalInstance()->setMaxThreadCount(MAX_THREAD_COUNT);
+
+        StartupManager::instance()->mark("translations and theme");
+
 #ifdef MENU_DIALOG_PLUGIN
         // by txx 加载插件
         pluginManagerApp->loadPlugin();
 #endif
 
+        /// the first window doesn't need these, they run once it has painted
+        StartupManager::instance()->addDeferredTask("xdnd workaround", [] {
+            /// fix Qt drag drop to google chrome bug
+            new XdndWorkaround();
+        });
+        StartupManager::instance()->addDeferredTask("dialogs", [] {
+            dialogManager;
+        });
+        StartupManager::instance()->addDeferredTask("gvfs", [] {
+            appController->createGVfSManager();
+        });
+        StartupManager::instance()->addDeferredTask("default file manager", [] {
+            FileUtils::setDefaultFileManager();
+        });
+
         if (!isBackendRun){
+            /// smb:// and friends can't list without the gvfs managers
+            if (!commandlineUrl.isLocalFile())
+                StartupManager::instance()->ensure("gvfs");
+
             fileManagerApp->show(commandlineUrl);
+
+            StartupManager::instance()->mark("window shown");
+            StartupManager::instance()->runDeferredTasksAfterFirstFrame();
         }else{
+            StartupManager::instance()->runDeferredTasks();
             fileManagerApp->runCacheTask();
         }
-
-        QTranslator translator_qt;
-        if (translator_qt.load(QLibraryInfo::location(QLibraryInfo::TranslationsPath) + "/qt_" + QLocale::system().name() + ".qm"))
-            app.installTranslator(&translator_qt);
-
-        /// fix Qt drag drop to google chrome bug
-        new XdndWorkaround();
-
-        dialogManager;
-        appController->createGVfSManager();
-        QThreadPool::globalInstance()->setMaxThreadCount(MAX_THREAD_COUNT);
-        FileUtils::setDefaultFileManager();
 #ifdef ENABLE_PPROF
         int request = app.exec();
 
+        if (Tracer::isEnabled())
+            Tracer::instance()->dump();
+
         ProfilerStop();
         quick_exit(request);
 #else
         int ret = app.exec();
+
+        if (Tracer::isEnabled())
+            Tracer::instance()->dump();
+
 #ifdef AUTO_RESTART_DEAMON
         app.closeServer();
         QProcess::startDetached(QString("%1 -d").arg(QString(argv[0])));
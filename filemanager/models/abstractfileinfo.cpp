@@ -1,4 +1,5 @@
 #include "abstractfileinfo.h"
+#include "filesortkeys.h"
 
 #include "../views/dfileview.h"
 
@@ -6,6 +7,7 @@
 
 #include "../shutil/fileutils.h"
 #include "../shutil/mimetypedisplaymanager.h"
+#include "../shutil/childcountmanager.h"
 
 #include "../controllers/pathmanager.h"
 #include "../controllers/fileservices.h"
@@ -266,7 +268,16 @@ qint64 AbstractFileInfo::size() const
         }
         return data->size;
     }else{
-        return filesCount();
+        /// painting and sorting come here for every row, the entries are
+        /// counted by childCountManager and are -1 until it is done
+        const QString &filePath = data->fileInfo.absoluteFilePath();
+        qint64 mtime = lastModified().toMSecsSinceEpoch();
+        qint64 count = -1;
+
+        if (!childCountManager->childCount(filePath, mtime, &count))
+            childCountManager->requestChildCount(filePath, mtime);
+
+        return count;
     }
 }
 
@@ -316,10 +327,14 @@ QString AbstractFileInfo::sizeDisplayName() const
     if (isFile()){
         return FileUtils::formatSize(size());
     }else{
-        if (size() <= 1){
-            return QObject::tr("%1 item").arg(size());
+        qint64 count = size();
+
+        if (count < 0){
+            return QStringLiteral("-");
+        }else if (count <= 1){
+            return QObject::tr("%1 item").arg(count);
         }else{
-            return QObject::tr("%1 items").arg(size());
+            return QObject::tr("%1 items").arg(count);
         }
     }
 }
@@ -547,6 +562,18 @@ void AbstractFileInfo::sortByColumnRole(QList<AbstractFileInfoPointer> &fileList
     if (!FileSortFunction::sortFun)
         return;
 
+    /// a subclass that replaced one of the standard comparators keeps it
+    typedef bool (*SortFunctionPointer)(const AbstractFileInfoPointer&, const AbstractFileInfoPointer&, Qt::SortOrder);
+    const sortFunction &standardFun = AbstractFileInfo::sortFunByColumn(columnRole);
+    const SortFunctionPointer *target = FileSortFunction::sortFun.target<SortFunctionPointer>();
+    const SortFunctionPointer *standardTarget = standardFun.target<SortFunctionPointer>();
+
+    if (FileSortKeys::isSupported(columnRole) && target && standardTarget && *target == *standardTarget) {
+        FileSortKeys(fileList, columnRole).sort(fileList, order);
+
+        return;
+    }
+
     qSort(fileList.begin(), fileList.end(), FileSortFunction::sort);
 }
 
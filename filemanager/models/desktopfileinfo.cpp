@@ -2,13 +2,11 @@
 
 #include "../app/global.h"
 
-#include "../shutil/properties.h"
+#include "../shutil/desktopfile.h"
 #include "../shutil/iconprovider.h"
 
 #include "widgets/singleton.h"
 
-#include <QSettings>
-
 DesktopFileInfo::DesktopFileInfo() :
     FileInfo()
 {
@@ -83,24 +81,14 @@ QString DesktopFileInfo::displayName() const
 QMap<QString, QVariant> DesktopFileInfo::getDesktopFileInfo(const DUrl &fileUrl)
 {
     QMap<QString, QVariant> map;
-    QSettings settings(fileUrl.path(), QSettings::IniFormat);
-
-    settings.beginGroup("Desktop Entry");
-    // Loads .desktop file (read from 'Desktop Entry' group)
-    Properties desktop(fileUrl.path(), "Desktop Entry");
-
-    const QString &name = desktop.value("Name[" + QLocale::system().name() + "]", settings.value("Name[" + QLocale::system().name() + "]")).toString();
-
-    if (name.isEmpty())
-        map["Name"] = desktop.value("Name", settings.value("Name"));
-    else
-        map["Name"] = name;
+    const DesktopFile desktop(fileUrl.path());
 
-    map["Exec"] = desktop.value("Exec", settings.value("Exec"));
-    map["Icon"] = desktop.value("Icon", settings.value("Icon"));
-    map["Type"] = desktop.value("Type", settings.value("Type", "Application"));
-    map["Categories"] = desktop.value("Categories", settings.value("Categories")).toString().remove(" ").split(";");
-    map["MimeType"] = desktop.value("MimeType", settings.value("MimeType")).toString().remove(" ").split(";");
+    map["Name"] = desktop.getLocalName();
+    map["Exec"] = desktop.getExec();
+    map["Icon"] = desktop.getIcon();
+    map["Type"] = desktop.getType();
+    map["Categories"] = desktop.getCategories();
+    map["MimeType"] = desktop.getMimeType();
 
     return map;
 }
@@ -115,9 +103,5 @@ void DesktopFileInfo::init(const DUrl &fileUrl)
     type = map.value("Type").toString();
     categories = map.value("Categories").toStringList();
     mimeType = map.value("MimeType").toStringList();
-    // Fix categories
-    if (categories.first().compare("") == 0) {
-      categories.removeFirst();
-    }
 }
 
@@ -1,10 +1,12 @@
 #include "dfilesystemmodel.h"
 #include "desktopfileinfo.h"
 #include "abstractfileinfo.h"
+#include "directorysnapshotcache.h"
 
 #include "../app/global.h"
 #include "../app/filemanagerapp.h"
 #include "../app/fmevent.h"
+#include "../app/tracer.h"
 
 #include "../views/dfileview.h"
 
@@ -17,6 +19,8 @@
 #include "../shutil/mimetypedisplaymanager.h"
 #include "../shutil/fileutils.h"
 
+#include "widgets/singleton.h"
+
 #include <QDebug>
 #include <QFileIconProvider>
 #include <QDateTime>
@@ -25,6 +29,8 @@
 
 #define fileService FileServices::instance()
 #define DEFAULT_COLUMN_COUNT 1
+/// a revalidation that changes more rows than this resets the list instead
+#define REVALIDATION_MAX_CHANGES 1000
 
 class FileSystemNode : public QSharedData
 {
@@ -44,8 +50,25 @@ public:
     }
 };
 
+static QList<AbstractFileInfoPointer> listChildren(const DUrl &fileUrl, QDir::Filters filters)
+{
+    QList<AbstractFileInfoPointer> list;
+    const DDirIteratorPointer &iterator = fileService->createDirIterator(fileUrl, filters);
+
+    if (!iterator)
+        return fileService->getChildren(fileUrl, filters);
+
+    while (iterator->hasNext()) {
+        iterator->next();
+        list << iterator->fileInfo();
+    }
+
+    return list;
+}
+
 DFileSystemModel::DFileSystemModel(DFileView *parent)
     : QAbstractItemModel(parent)
+    , m_revalidationWatcher(new QFutureWatcher<QList<AbstractFileInfoPointer>>(this))
 {
     connect(fileService, &FileServices::childrenAdded,
             this, &DFileSystemModel::onFileCreated,
@@ -55,6 +78,12 @@ DFileSystemModel::DFileSystemModel(DFileView *parent)
             Qt::DirectConnection);
     connect(fileService, &FileServices::childrenUpdated,
             this, &DFileSystemModel::onFileUpdated);
+    connect(m_revalidationWatcher, &QFutureWatcher<QList<AbstractFileInfoPointer>>::finished,
+            this, &DFileSystemModel::onRevalidationFinished);
+    /// the rows change on the sort workers too, these arrive queued then
+    connect(this, &DFileSystemModel::rowsInserted, this, &DFileSystemModel::invalidatePrefixIndex);
+    connect(this, &DFileSystemModel::rowsRemoved, this, &DFileSystemModel::invalidatePrefixIndex);
+    connect(this, &DFileSystemModel::modelReset, this, &DFileSystemModel::invalidatePrefixIndex);
 
     qRegisterMetaType<State>("State");
     qRegisterMetaType<AbstractFileInfoPointer>("AbstractFileInfoPointer");
@@ -395,7 +424,36 @@ void DFileSystemModel::fetchMore(const QModelIndex &parent)
         }
     }
 
-    jobController = fileService->getChildrenJob(parentNode->fileInfo->fileUrl(), m_filters);
+    const DUrl &fileUrl = parentNode->fileInfo->fileUrl();
+    DirectorySnapshotCache::Snapshot snapshot;
+
+    /// a recently listed folder shows its snapshot right away, the listing
+    /// runs behind it and only patches the rows that changed meanwhile
+    if (DirectorySnapshotCache::isCacheable(fileUrl) && directorySnapshotCache->snapshot(fileUrl, m_filters, &snapshot)) {
+        jobController.clear();
+
+        fileService->addUrlMonitor(fileUrl);
+
+        parentNode->populatedChildren = true;
+
+        setState(Busy);
+
+        childrenUpdated = false;
+        m_revalidationUrl = fileUrl;
+        m_revalidationWatcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), listChildren, fileUrl, m_filters));
+
+        /// the infos of a snapshot belong to the model that saved it, they
+        /// are sorted and painted there, so this model makes its own
+        for (AbstractFileInfoPointer &info : snapshot.children) {
+            info = fileService->createFileInfo(info->fileUrl());
+        }
+
+        populateChildren(snapshot.children, snapshot.sortRole == m_sortRole && snapshot.sortOrder == m_srotOrder);
+
+        return;
+    }
+
+    jobController = fileService->getChildrenJob(fileUrl, m_filters);
 
     if (!jobController)
         return;
@@ -404,7 +462,7 @@ void DFileSystemModel::fetchMore(const QModelIndex &parent)
     connect(jobController, &JobController::finished, this, &DFileSystemModel::onJobFinished, Qt::QueuedConnection);
     connect(jobController, &JobController::childrenUpdated, this, &DFileSystemModel::updateChildren, Qt::QueuedConnection);
 
-    fileService->addUrlMonitor(parentNode->fileInfo->fileUrl());
+    fileService->addUrlMonitor(fileUrl);
 
     parentNode->populatedChildren = true;
 
@@ -652,6 +710,8 @@ void DFileSystemModel::sort()
         return;
     }
 
+    TRACE_SCOPE("DFileSystemModel::sort");
+
 //    const FileSystemNodePointer &node = getNodeByIndex(m_activeIndex);
     const FileSystemNodePointer &node = m_rootNode;
 
@@ -690,6 +750,7 @@ void DFileSystemModel::sort()
     QModelIndex topLeftIndex = index(0, 0, parentIndex);
     QModelIndex rightBottomIndex = index(node->visibleChildren.count(), columnCount(parentIndex), parentIndex);
 
+    QMetaObject::invokeMethod(this, "invalidatePrefixIndex", Qt::QueuedConnection);
     QMetaObject::invokeMethod(this, "dataChanged", Qt::QueuedConnection,
                               Q_ARG(QModelIndex, topLeftIndex), Q_ARG(QModelIndex, rightBottomIndex));
 }
@@ -742,17 +803,69 @@ DFileSystemModel::State DFileSystemModel::state() const
     return m_state;
 }
 
+QModelIndex DFileSystemModel::keyboardSearch(const QString &prefix, int startRow) const
+{
+    const FileSystemNodePointer &node = m_rootNode;
+
+    if (!node || prefix.isEmpty())
+        return QModelIndex();
+
+    const int count = node->visibleChildren.count();
+
+    if (!m_prefixIndexValid || m_prefixIndex.count() != count)
+        buildPrefixIndex();
+
+    const QString &key = prefix.toLower();
+    auto it = std::lower_bound(m_prefixIndex.constBegin(), m_prefixIndex.constEnd(), key,
+                               [] (const PrefixEntry &entry, const QString &key) {
+        return entry.key < key;
+    });
+
+    int caseSensitiveDistance = count;
+    int caseInsensitiveDistance = count;
+    int caseSensitiveRow = -1;
+    int caseInsensitiveRow = -1;
+
+    for (; it != m_prefixIndex.constEnd() && it->key.startsWith(key); ++it) {
+        int distance = ((it->row - startRow) % count + count) % count;
+
+        if (it->name.startsWith(prefix)) {
+            if (distance < caseSensitiveDistance) {
+                caseSensitiveDistance = distance;
+                caseSensitiveRow = it->row;
+            }
+        } else if (distance < caseInsensitiveDistance) {
+            caseInsensitiveDistance = distance;
+            caseInsensitiveRow = it->row;
+        }
+    }
+
+    int row = caseSensitiveRow >= 0 ? caseSensitiveRow : caseInsensitiveRow;
+
+    if (row < 0)
+        return QModelIndex();
+
+    return index(row, 0, createIndex(node, 0));
+}
+
 void DFileSystemModel::updateChildren(QList<AbstractFileInfoPointer> list)
+{
+    populateChildren(list, false);
+}
+
+void DFileSystemModel::populateChildren(QList<AbstractFileInfoPointer> list, bool sorted)
 {
     if (qApp->thread() == QThread::currentThread()) {
         if (QThreadPool::globalInstance()->activeThreadCount() >= QThreadPool::globalInstance()->maxThreadCount())
             QThreadPool::globalInstance()->setMaxThreadCount(QThreadPool::globalInstance()->maxThreadCount() + 10);
 
-        updateChildrenFuture = QtConcurrent::run(QThreadPool::globalInstance(), this, &DFileSystemModel::updateChildren, list);
+        updateChildrenFuture = QtConcurrent::run(QThreadPool::globalInstance(), this, &DFileSystemModel::populateChildren, list, sorted);
 
         return;
     };
 
+    TRACE_SCOPE("DFileSystemModel::updateChildren");
+
     const FileSystemNodePointer &node = m_rootNode;
 
     if(!node) {
@@ -771,7 +884,8 @@ void DFileSystemModel::updateChildren(QList<AbstractFileInfoPointer> list)
     node->children.clear();
     node->visibleChildren.clear();
 
-    sort(node->fileInfo, list);
+    if (!sorted)
+        sort(node->fileInfo, list);
 
     beginInsertRows(createIndex(node, 0), 0, list.count() - 1);
 
@@ -813,6 +927,8 @@ void DFileSystemModel::refresh(const DUrl &fileUrl)
 
     node->populatedChildren = false;
 
+    directorySnapshotCache->remove(node->fileInfo->fileUrl());
+
     const QModelIndex &index = createIndex(node, 0);
 
     beginRemoveRows(index, 0, rowCount(index) - 1);
@@ -1003,11 +1119,72 @@ void DFileSystemModel::deleteNodeByUrl(const DUrl &url)
     //    m_urlToNode.take(url);
 }
 
+void DFileSystemModel::saveSnapshot()
+{
+    const FileSystemNodePointer &node = m_rootNode;
+
+    if (!node || !node->populatedChildren || m_state != Idle || qApp->thread() != QThread::currentThread())
+        return;
+
+    const DUrl &fileUrl = node->fileInfo->fileUrl();
+
+    if (!DirectorySnapshotCache::isCacheable(fileUrl))
+        return;
+
+    DirectorySnapshotCache::Snapshot snapshot;
+
+    snapshot.children.reserve(node->visibleChildren.count());
+    snapshot.sortRole = m_sortRole;
+    snapshot.sortOrder = m_srotOrder;
+
+    for (const DUrl &url : node->visibleChildren) {
+        const FileSystemNodePointer &child = node->children.value(url);
+
+        if (child)
+            snapshot.children << child->fileInfo;
+    }
+
+    directorySnapshotCache->insert(fileUrl, m_filters, snapshot);
+}
+
+void DFileSystemModel::buildPrefixIndex() const
+{
+    const FileSystemNodePointer &node = m_rootNode;
+
+    m_prefixIndex.clear();
+    m_prefixIndex.reserve(node->visibleChildren.count());
+
+    for (int i = 0; i < node->visibleChildren.count(); ++i) {
+        const FileSystemNodePointer &child = node->children.value(node->visibleChildren.at(i));
+
+        if (!child)
+            continue;
+
+        const QString &name = child->fileInfo->pinyinName();
+
+        m_prefixIndex << PrefixEntry{name.toLower(), name, i};
+    }
+
+    std::sort(m_prefixIndex.begin(), m_prefixIndex.end(), [] (const PrefixEntry &entry1, const PrefixEntry &entry2) {
+        return entry1.key < entry2.key;
+    });
+
+    m_prefixIndexValid = true;
+}
+
+void DFileSystemModel::invalidatePrefixIndex()
+{
+    m_prefixIndexValid = false;
+    m_prefixIndex.clear();
+}
+
 void DFileSystemModel::clear()
 {
     if (!m_rootNode)
         return;
 
+    saveSnapshot();
+
     const QModelIndex &index = createIndex(m_rootNode, 0);
 
     beginRemoveRows(index, 0, rowCount(index) - 1);
@@ -1031,6 +1208,86 @@ void DFileSystemModel::onJobFinished()
 {
     if (childrenUpdated)
         setState(Idle);
+
+    saveSnapshot();
+}
+
+void DFileSystemModel::onRevalidationFinished()
+{
+    if (updateChildrenFuture.isRunning())
+        updateChildrenFuture.waitForFinished();
+
+    /// a copy, addFile() runs the event loop and the root may change meanwhile
+    const FileSystemNodePointer node = m_rootNode;
+
+    if (!node || !node->populatedChildren || node->fileInfo->fileUrl() != m_revalidationUrl)
+        return;
+
+    const QList<AbstractFileInfoPointer> &list = m_revalidationWatcher->result();
+    QHash<DUrl, AbstractFileInfoPointer> newChildren;
+
+    newChildren.reserve(list.count());
+
+    for (const AbstractFileInfoPointer &info : list) {
+        newChildren[info->fileUrl()] = info;
+    }
+
+    QList<DUrl> removedList;
+    QList<AbstractFileInfoPointer> addedList;
+    QList<AbstractFileInfoPointer> changedList;
+
+    for (const DUrl &url : node->visibleChildren) {
+        if (!newChildren.contains(url))
+            removedList << url;
+    }
+
+    for (const AbstractFileInfoPointer &info : list) {
+        const FileSystemNodePointer &child = node->children.value(info->fileUrl());
+
+        if (!child)
+            addedList << info;
+        else if (child->fileInfo->lastModified() != info->lastModified())
+            changedList << info;
+    }
+
+    if (removedList.count() + addedList.count() + changedList.count() > REVALIDATION_MAX_CHANGES) {
+        updateChildren(list);
+
+        return;
+    }
+
+    for (const DUrl &url : removedList) {
+        int row = node->visibleChildren.indexOf(url);
+
+        beginRemoveRows(createIndex(node, 0), row, row);
+        node->visibleChildren.removeAt(row);
+        node->children.remove(url);
+        endRemoveRows();
+    }
+
+    QPointer<DFileSystemModel> me = this;
+
+    for (const AbstractFileInfoPointer &info : addedList) {
+        addFile(info);
+
+        if (!me || m_rootNode != node || node->fileInfo->fileUrl() != m_revalidationUrl)
+            return;
+    }
+
+    for (const AbstractFileInfoPointer &info : changedList) {
+        const FileSystemNodePointer &child = node->children.value(info->fileUrl());
+
+        if (!child)
+            continue;
+
+        child->fileInfo = info;
+
+        const QModelIndex &index = createIndex(child, 0);
+
+        emit dataChanged(index, index.sibling(index.row(), columnCount() - 1));
+    }
+
+    saveSnapshot();
 }
 
 void DFileSystemModel::addFile(const AbstractFileInfoPointer &fileInfo)
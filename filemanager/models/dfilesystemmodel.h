@@ -5,6 +5,8 @@
 #include <QPointer>
 #include <QDir>
 #include <QFuture>
+#include <QFutureWatcher>
+#include <QVector>
 
 #include "durl.h"
 #include "abstractfileinfo.h"
@@ -115,6 +117,10 @@ public:
 
     State state() const;
 
+    /// the first row from \a startRow on, wrapping around, whose pinyin name
+    /// starts with \a prefix; a case sensitive match wins over the others
+    QModelIndex keyboardSearch(const QString &prefix, int startRow) const;
+
 public slots:
     void updateChildren(QList<AbstractFileInfoPointer> list);
     /// warning: only refresh current url
@@ -130,8 +136,18 @@ private slots:
     void onFileCreated(const DUrl &fileUrl);
     void onFileDeleted(const DUrl &fileUrl);
     void onFileUpdated(const DUrl &fileUrl);
+    void onRevalidationFinished();
+    void invalidatePrefixIndex();
 
 private:
+    struct PrefixEntry
+    {
+        /// lower case pinyin name
+        QString key;
+        QString name;
+        int row;
+    };
+
     FileSystemNodePointer m_rootNode;
 
 //    QHash<DUrl, FileSystemNodePointer> m_urlToNode;
@@ -144,11 +160,17 @@ private:
     QPointer<JobController> jobController;
     QEventLoop *eventLoop = Q_NULLPTR;
     QFuture<void> updateChildrenFuture;
+    QFutureWatcher<QList<AbstractFileInfoPointer>> *m_revalidationWatcher;
+    DUrl m_revalidationUrl;
 
     State m_state = Idle;
 
     bool childrenUpdated = false;
 
+    /// the rows sorted by name for type-ahead, built when a key is typed
+    mutable QVector<PrefixEntry> m_prefixIndex;
+    mutable bool m_prefixIndexValid = false;
+
     inline const FileSystemNodePointer getNodeByIndex(const QModelIndex &index) const;
     QModelIndex createIndex(const FileSystemNodePointer &node, int column) const;
     using QAbstractItemModel::createIndex;
@@ -156,6 +178,9 @@ private:
     bool isDir(const FileSystemNodePointer &node) const;
 
     void sort(const AbstractFileInfoPointer &parentInfo, QList<AbstractFileInfoPointer> &list) const;
+    void populateChildren(QList<AbstractFileInfoPointer> list, bool sorted);
+    void saveSnapshot();
+    void buildPrefixIndex() const;
 
     const FileSystemNodePointer createNode(FileSystemNode *parent, const AbstractFileInfoPointer &info);
 
@@ -0,0 +1,119 @@
+#include "directorysnapshotcache.h"
+
+#include "../app/global.h"
+
+#include "../controllers/fileservices.h"
+
+/// the cost is an estimate of the file infos in KiB, about one per entry
+#define DIRECTORY_SNAPSHOT_CACHE_MAX_COST (128 * 1024)
+#define DIRECTORY_SNAPSHOT_MIN_COUNT 64
+
+DirectorySnapshotCache::DirectorySnapshotCache(QObject *parent)
+    : QObject(parent)
+    , m_snapshots(DIRECTORY_SNAPSHOT_CACHE_MAX_COST)
+{
+    connect(fileService, &FileServices::childrenAdded, this, &DirectorySnapshotCache::onChildAdded);
+    connect(fileService, &FileServices::childrenRemoved, this, &DirectorySnapshotCache::onChildRemoved);
+}
+
+bool DirectorySnapshotCache::isCacheable(const DUrl &fileUrl)
+{
+    return fileUrl.isLocalFile();
+}
+
+bool DirectorySnapshotCache::snapshot(const DUrl &fileUrl, QDir::Filters filters, DirectorySnapshotCache::Snapshot *snapshot) const
+{
+    const Snapshot *cached = m_snapshots.object(SnapshotKey(fileUrl, int(filters)));
+
+    if (!cached)
+        return false;
+
+    *snapshot = *cached;
+
+    return true;
+}
+
+void DirectorySnapshotCache::insert(const DUrl &fileUrl, QDir::Filters filters, const DirectorySnapshotCache::Snapshot &snapshot)
+{
+    /// small folders list faster than they would be revalidated
+    if (!isCacheable(fileUrl) || snapshot.children.count() < DIRECTORY_SNAPSHOT_MIN_COUNT) {
+        m_snapshots.remove(SnapshotKey(fileUrl, int(filters)));
+
+        return;
+    }
+
+    m_snapshots.insert(SnapshotKey(fileUrl, int(filters)), new Snapshot(snapshot), snapshot.children.count());
+}
+
+void DirectorySnapshotCache::remove(const DUrl &fileUrl)
+{
+    for (const SnapshotKey &key : keysOf(fileUrl)) {
+        m_snapshots.remove(key);
+    }
+}
+
+void DirectorySnapshotCache::onChildAdded(const DUrl &fileUrl)
+{
+    const QList<SnapshotKey> &keys = keysOf(fileUrl.parentUrl());
+
+    if (keys.isEmpty())
+        return;
+
+    const AbstractFileInfoPointer &info = fileService->createFileInfo(fileUrl);
+
+    if (!info)
+        return;
+
+    for (const SnapshotKey &key : keys) {
+        Snapshot *snapshot = m_snapshots.object(key);
+
+        if (info->isHidden() && !(QDir::Filters(key.second) & QDir::Hidden))
+            continue;
+
+        bool contains = false;
+
+        for (const AbstractFileInfoPointer &child : snapshot->children) {
+            if (child->fileUrl() == fileUrl) {
+                contains = true;
+
+                break;
+            }
+        }
+
+        if (contains)
+            continue;
+
+        /// the model that takes the snapshot sorts it again
+        snapshot->children << info;
+        snapshot->sortRole = -1;
+    }
+}
+
+void DirectorySnapshotCache::onChildRemoved(const DUrl &fileUrl)
+{
+    remove(fileUrl);
+
+    for (const SnapshotKey &key : keysOf(fileUrl.parentUrl())) {
+        Snapshot *snapshot = m_snapshots.object(key);
+
+        for (int i = 0; i < snapshot->children.count(); ++i) {
+            if (snapshot->children.at(i)->fileUrl() == fileUrl) {
+                snapshot->children.removeAt(i);
+
+                break;
+            }
+        }
+    }
+}
+
+QList<DirectorySnapshotCache::SnapshotKey> DirectorySnapshotCache::keysOf(const DUrl &fileUrl) const
+{
+    QList<SnapshotKey> keys;
+
+    for (const SnapshotKey &key : m_snapshots.keys()) {
+        if (key.first == fileUrl)
+            keys << key;
+    }
+
+    return keys;
+}
@@ -0,0 +1,51 @@
+#ifndef DIRECTORYSNAPSHOTCACHE_H
+#define DIRECTORYSNAPSHOTCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QPair>
+#include <QDir>
+
+#include "durl.h"
+#include "abstractfileinfo.h"
+
+/// The children of recently listed local directories, shared by all models so
+/// that Back/Forward and a second window on the same folder show the rows at
+/// once. The infos in a snapshot are those of the model that saved it, a
+/// model using it creates its own from the urls. The lists follow the
+/// FileMonitor deltas while the directory is watched, a model revalidates a
+/// snapshot when it uses one.
+class DirectorySnapshotCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Snapshot
+    {
+        QList<AbstractFileInfoPointer> children;
+        /// how children are ordered, -1 after a delta was appended
+        int sortRole = -1;
+        Qt::SortOrder sortOrder = Qt::AscendingOrder;
+    };
+
+    explicit DirectorySnapshotCache(QObject *parent = 0);
+
+    static bool isCacheable(const DUrl &fileUrl);
+
+    bool snapshot(const DUrl &fileUrl, QDir::Filters filters, Snapshot *snapshot) const;
+    void insert(const DUrl &fileUrl, QDir::Filters filters, const Snapshot &snapshot);
+    void remove(const DUrl &fileUrl);
+
+private slots:
+    void onChildAdded(const DUrl &fileUrl);
+    void onChildRemoved(const DUrl &fileUrl);
+
+private:
+    typedef QPair<DUrl, int> SnapshotKey;
+
+    QList<SnapshotKey> keysOf(const DUrl &fileUrl) const;
+
+    mutable QCache<SnapshotKey, Snapshot> m_snapshots;
+};
+
+#endif // DIRECTORYSNAPSHOTCACHE_H
@@ -152,6 +152,16 @@ DUrl DUrl::searchedFileUrl() const
     return DUrl(fragment(FullyEncoded));
 }
 
+bool DUrl::searchContent() const
+{
+    if (!isSearchFile())
+        return false;
+
+    QUrlQuery query(this->query());
+
+    return query.queryItemValue("content") == "1";
+}
+
 DUrl DUrl::parentUrl() const
 {
     return parentUrl(*this);
@@ -191,6 +201,21 @@ void DUrl::setSearchedFileUrl(const DUrl &url)
     setFragment(url.toString());
 }
 
+void DUrl::setSearchContent(bool content)
+{
+    if (!isSearchFile())
+        return;
+
+    QUrlQuery query(this->query());
+
+    query.removeQueryItem("content");
+
+    if (content)
+        query.addQueryItem("content", "1");
+
+    setQuery(query);
+}
+
 DUrl DUrl::fromLocalFile(const QString &filePath)
 {
     return QUrl::fromLocalFile(filePath);
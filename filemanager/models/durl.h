@@ -41,12 +41,15 @@ public:
     QString searchKeyword() const;
     DUrl searchTargetUrl() const;
     DUrl searchedFileUrl() const;
+    /// search inside the files instead of their names
+    bool searchContent() const;
 
     DUrl parentUrl() const;
 
     void setSearchKeyword(const QString &keyword);
     void setSearchTargetUrl(const DUrl &url);
     void setSearchedFileUrl(const DUrl &url);
+    void setSearchContent(bool content);
 
     static DUrl fromLocalFile(const QString &filePath);
     static DUrl fromTrashFile(const QString &filePath);
@@ -0,0 +1,206 @@
+#include "filesortkeys.h"
+#include "dfilesystemmodel.h"
+
+#include "../app/global.h"
+
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+
+/// below this a single thread is faster than handing out the chunks
+#define FILE_SORT_PARALLEL_MIN_COUNT 8192
+
+struct FileSortKeys::SortRange
+{
+    const FileSortKeys *keys;
+    Qt::SortOrder order;
+    int *first;
+    int *middle;
+    int *last;
+};
+
+FileSortKeys::FileSortKeys(const QList<AbstractFileInfoPointer> &fileList, int columnRole)
+{
+    const int count = fileList.count();
+
+    m_stringValue = columnRole == DFileSystemModel::FileDisplayNameRole;
+
+    m_kinds.reserve(count);
+    m_startWithHanzi.reserve(count);
+    m_nameKeys.reserve(count);
+
+    if (!m_stringValue)
+        m_values.reserve(count);
+
+    for (const AbstractFileInfoPointer &info : fileList) {
+        const QString &name = info->displayName();
+
+        m_kinds << (info->isDir() ? DirKind : info->isFile() ? FileKind : OtherKind);
+        m_startWithHanzi << Global::startWithHanzi(name);
+        m_nameKeys << name;
+
+        switch (columnRole) {
+        case DFileSystemModel::FileSizeRole:
+            m_values << info->size();
+            break;
+        case DFileSystemModel::FileLastModifiedRole:
+            m_values << info->lastModified().toMSecsSinceEpoch();
+            break;
+        case DFileSystemModel::FileCreatedRole:
+            m_values << info->created().toMSecsSinceEpoch();
+            break;
+        case DFileSystemModel::FileMimeTypeRole:
+            m_values << info->mimeTypeDisplayNameOrder();
+            break;
+        default:
+            break;
+        }
+    }
+
+    /// the getters above aren't safe to call from several threads, the
+    /// pinyin conversion is
+    if (count < FILE_SORT_PARALLEL_MIN_COUNT) {
+        for (QString &name : m_nameKeys) {
+            makeNameKey(name);
+        }
+    } else {
+        QtConcurrent::blockingMap(m_nameKeys, makeNameKey);
+    }
+}
+
+bool FileSortKeys::isSupported(int columnRole)
+{
+    switch (columnRole) {
+    case DFileSystemModel::FileDisplayNameRole:
+    case DFileSystemModel::FileSizeRole:
+    case DFileSystemModel::FileLastModifiedRole:
+    case DFileSystemModel::FileCreatedRole:
+    case DFileSystemModel::FileMimeTypeRole:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void FileSortKeys::sort(QList<AbstractFileInfoPointer> &fileList, Qt::SortOrder order) const
+{
+    const int count = fileList.count();
+
+    Q_ASSERT(count == m_kinds.count());
+
+    QVector<int> indexes(count);
+
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    int *data = indexes.data();
+
+    if (count < FILE_SORT_PARALLEL_MIN_COUNT) {
+        SortRange range{this, order, data, data, data + count};
+
+        sortRange(range);
+    } else {
+        const int chunkCount = qBound(1, QThread::idealThreadCount(), count / (FILE_SORT_PARALLEL_MIN_COUNT / 2));
+        QVector<SortRange> ranges;
+
+        for (int i = 0; i < chunkCount; ++i) {
+            int *first = data + qint64(count) * i / chunkCount;
+            int *last = data + qint64(count) * (i + 1) / chunkCount;
+
+            ranges << SortRange{this, order, first, first, last};
+        }
+
+        QtConcurrent::blockingMap(ranges, sortRange);
+
+        /// neighbours are merged pairwise, which keeps the sort stable
+        while (ranges.count() > 1) {
+            QVector<SortRange> merges;
+
+            for (int i = 0; i + 1 < ranges.count(); i += 2) {
+                merges << SortRange{this, order, ranges.at(i).first, ranges.at(i).last, ranges.at(i + 1).last};
+            }
+
+            QtConcurrent::blockingMap(merges, mergeRanges);
+
+            if (ranges.count() % 2 != 0)
+                merges << ranges.last();
+
+            ranges = merges;
+        }
+    }
+
+    QList<AbstractFileInfoPointer> sortedList;
+
+    sortedList.reserve(count);
+
+    for (int index : indexes) {
+        sortedList << fileList.at(index);
+    }
+
+    fileList = sortedList;
+}
+
+/// the order FileSortFunction's comparators define: directories first, then
+/// the column value, then the name for equal values
+bool FileSortKeys::lessThan(int index1, int index2, Qt::SortOrder order) const
+{
+    quint8 kind1 = m_kinds.at(index1);
+    quint8 kind2 = m_kinds.at(index2);
+
+    if ((kind1 == DirKind) != (kind2 == DirKind))
+        return kind1 == DirKind;
+
+    if (m_stringValue)
+        return nameLessThan(index1, index2, order);
+
+    qint64 value1 = m_values.at(index1);
+    qint64 value2 = m_values.at(index2);
+
+    if (value1 == value2)
+        return kind1 == kind2 && kind1 != OtherKind && nameLessThan(index1, index2, Qt::AscendingOrder);
+
+    return (value1 < value2) != (order == Qt::DescendingOrder);
+}
+
+bool FileSortKeys::nameLessThan(int index1, int index2, Qt::SortOrder order) const
+{
+    bool hanzi1 = m_startWithHanzi.at(index1);
+    bool hanzi2 = m_startWithHanzi.at(index2);
+
+    if (hanzi1 != hanzi2)
+        return hanzi1 == (order != Qt::AscendingOrder);
+
+    const QString &key1 = m_nameKeys.at(index1);
+    const QString &key2 = m_nameKeys.at(index2);
+
+    if (key1 == key2)
+        return false;
+
+    return (key1 < key2) != (order == Qt::DescendingOrder);
+}
+
+void FileSortKeys::sortRange(FileSortKeys::SortRange &range)
+{
+    const FileSortKeys *keys = range.keys;
+    Qt::SortOrder order = range.order;
+
+    std::stable_sort(range.first, range.last, [keys, order] (int index1, int index2) {
+        return keys->lessThan(index1, index2, order);
+    });
+}
+
+void FileSortKeys::mergeRanges(FileSortKeys::SortRange &range)
+{
+    const FileSortKeys *keys = range.keys;
+    Qt::SortOrder order = range.order;
+
+    std::inplace_merge(range.first, range.middle, range.last, [keys, order] (int index1, int index2) {
+        return keys->lessThan(index1, index2, order);
+    });
+}
+
+void FileSortKeys::makeNameKey(QString &name)
+{
+    name = Global::toPinyin(name).toLower();
+}
@@ -0,0 +1,48 @@
+#ifndef FILESORTKEYS_H
+#define FILESORTKEYS_H
+
+#include <QVector>
+#include <QString>
+
+#include "abstractfileinfo.h"
+
+/// The values one of the standard columns sorts by, read once per file into
+/// plain arrays so that the comparisons don't call the virtual getters and
+/// don't convert names to pinyin again and again.
+class FileSortKeys
+{
+public:
+    FileSortKeys(const QList<AbstractFileInfoPointer> &fileList, int columnRole);
+
+    /// false for the columns this doesn't know, the caller sorts them as before
+    static bool isSupported(int columnRole);
+
+    /// a stable sort, large lists are sorted in chunks on the thread pool
+    void sort(QList<AbstractFileInfoPointer> &fileList, Qt::SortOrder order) const;
+
+private:
+    enum Kind : quint8 {
+        DirKind,
+        FileKind,
+        OtherKind
+    };
+
+    struct SortRange;
+
+    bool lessThan(int index1, int index2, Qt::SortOrder order) const;
+    bool nameLessThan(int index1, int index2, Qt::SortOrder order) const;
+
+    static void sortRange(SortRange &range);
+    static void mergeRanges(SortRange &range);
+    static void makeNameKey(QString &name);
+
+    bool m_stringValue = false;
+
+    QVector<quint8> m_kinds;
+    QVector<qint64> m_values;
+    QVector<bool> m_startWithHanzi;
+    /// lower case pinyin of the display names
+    QVector<QString> m_nameKeys;
+};
+
+#endif // FILESORTKEYS_H
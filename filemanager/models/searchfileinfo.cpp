@@ -294,6 +294,9 @@ QVariant SearchFileInfo::userColumnDisplayName(int userColumnRole) const
     if (userColumnRole == DFileSystemModel::FileUserRole + 1)
         return QObject::tr("Path", "SearchFileInfo");
 
+    if (userColumnRole == DFileSystemModel::FileUserRole + 2)
+        return QObject::tr("Match", "SearchFileInfo");
+
     return AbstractFileInfo::userColumnDisplayName(userColumnRole);
 }
 
@@ -309,12 +312,15 @@ QVariant SearchFileInfo::userColumnData(int userColumnRole) const
         }
     }
 
+    if (userColumnRole == DFileSystemModel::FileUserRole + 2)
+        return m_matchSnippet;
+
     return AbstractFileInfo::userColumnData(userColumnRole);
 }
 
 int SearchFileInfo::userColumnWidth(int userColumnRole) const
 {
-    if (userColumnRole == DFileSystemModel::FileUserRole + 1)
+    if (userColumnRole == DFileSystemModel::FileUserRole + 1 || userColumnRole == DFileSystemModel::FileUserRole + 2)
         return -1;
 
     return AbstractFileInfo::userColumnWidth(userColumnRole);
@@ -417,5 +423,20 @@ QString SearchFileInfo::subtitleForEmptyFloder() const
 void SearchFileInfo::init()
 {
     m_userColumnRoles.clear();
-    m_userColumnRoles << DFileSystemModel::FileUserRole + 1 << DFileSystemModel::FileSizeRole;
+    m_userColumnRoles << DFileSystemModel::FileUserRole + 1;
+
+    if (data->url.searchContent())
+        m_userColumnRoles << DFileSystemModel::FileUserRole + 2;
+
+    m_userColumnRoles << DFileSystemModel::FileSizeRole;
+}
+
+QString SearchFileInfo::matchSnippet() const
+{
+    return m_matchSnippet;
+}
+
+void SearchFileInfo::setMatchSnippet(const QString &snippet)
+{
+    m_matchSnippet = snippet;
 }
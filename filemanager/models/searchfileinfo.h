@@ -77,9 +77,14 @@ public:
     QString loadingTip() const Q_DECL_OVERRIDE;
     QString subtitleForEmptyFloder() const Q_DECL_OVERRIDE;
 
+    /// the matched text of a content search
+    QString matchSnippet() const;
+    void setMatchSnippet(const QString &snippet);
+
 private:
     DUrl m_parentUrl;
     AbstractFileInfoPointer realFileInfo;
+    QString m_matchSnippet;
 
     void init();
 };
@@ -7,13 +7,13 @@
 #include "../app/global.h"
 
 #include "../shutil/iconprovider.h"
+#include "../shutil/trashinfocache.h"
 
 #include "../models/dfilesystemmodel.h"
 
 #include "widgets/singleton.h"
 
 #include <QMimeType>
-#include <QSettings>
 
 namespace FileSortFunction {
 SORT_FUN_DEFINE(deletionDate, DeletionDate, TrashFileInfo)
@@ -270,21 +270,18 @@ void TrashFileInfo::updateInfo()
     const QString &basePath = TRASHFILEPATH;
     const QString &fileBaseName = filePath.mid(basePath.size(), filePath.indexOf('/', basePath.size() + 1) - basePath.size());
 
-    if (QFile::exists(TRASHINFOPATH + fileBaseName + ".trashinfo")) {
-        QSettings setting(TRASHINFOPATH + fileBaseName + ".trashinfo", QSettings::NativeFormat);
+    TrashInfoCache::TrashInfo info;
 
-        setting.beginGroup("Trash Info");
-        setting.setIniCodec("utf-8");
-
-        originalFilePath = QByteArray::fromPercentEncoding(setting.value("Path").toByteArray()) + filePath.mid(basePath.size() + fileBaseName.size());
+    if (trashInfoCache->trashInfo(fileBaseName.mid(1), &info)) {
+        originalFilePath = info.originalFilePath + filePath.mid(basePath.size() + fileBaseName.size());
 
         m_displayName = originalFilePath.mid(originalFilePath.lastIndexOf('/') + 1);
 
-        m_deletionDate = QDateTime::fromString(setting.value("DeletionDate").toString(), Qt::ISODate);
+        m_deletionDate = info.deletionDate;
         displayDeletionDate = m_deletionDate.toString(timeFormat());
 
         if (displayDeletionDate.isEmpty())
-            displayDeletionDate = setting.value("DeletionDate").toString();
+            displayDeletionDate = info.deletionDateString;
     } else {
         m_displayName = fileName();
     }
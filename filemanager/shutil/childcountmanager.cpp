@@ -0,0 +1,196 @@
+#include "childcountmanager.h"
+
+#include <QFile>
+#include <QStringList>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define CHILD_COUNT_BATCH_SIZE 64
+#define CHILD_COUNT_CACHE_MAX_COUNT 50000
+
+ChildCountManager::ChildCountManager(QObject *parent)
+    : QThread(parent)
+{
+
+}
+
+ChildCountManager::~ChildCountManager()
+{
+    m_mutex.lock();
+    m_quit = true;
+    m_condition.wakeAll();
+    m_mutex.unlock();
+
+    wait();
+}
+
+bool ChildCountManager::childCount(const QString &dirPath, qint64 mtime, qint64 *count)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_cache.constFind(dirPath);
+
+    if (it == m_cache.constEnd() || it->mtime != mtime)
+        return false;
+
+    *count = it->count;
+
+    return true;
+}
+
+void ChildCountManager::requestChildCount(const QString &dirPath, qint64 mtime)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_pending.find(dirPath);
+
+    if (it != m_pending.end() && it.value() == mtime)
+        return;
+
+    m_pending[dirPath] = mtime;
+    m_taskList << dirPath;
+    m_condition.wakeOne();
+
+    if (!isRunning())
+        start(QThread::LowPriority);
+}
+
+void ChildCountManager::removeChildCount(const QString &dirPath)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_pending.remove(dirPath);
+
+    if (m_cache.remove(dirPath) == 0)
+        return;
+
+    locker.unlock();
+
+    emit childCountChanged(dirPath);
+}
+
+void ChildCountManager::run()
+{
+    forever {
+        QStringList pathList;
+        QList<qint64> mtimeList;
+
+        m_mutex.lock();
+
+        while (!m_quit && m_taskList.isEmpty())
+            m_condition.wait(&m_mutex);
+
+        if (m_quit) {
+            m_mutex.unlock();
+
+            return;
+        }
+
+        /// newest requests first, they belong to the rows that are on screen now
+        while (!m_taskList.isEmpty() && pathList.count() < CHILD_COUNT_BATCH_SIZE) {
+            const QString &dirPath = m_taskList.takeLast();
+            auto it = m_pending.constFind(dirPath);
+
+            if (it == m_pending.constEnd() || pathList.contains(dirPath))
+                continue;
+
+            pathList << dirPath;
+            mtimeList << it.value();
+        }
+
+        m_mutex.unlock();
+
+        QList<qint64> countList;
+
+        for (const QString &dirPath : pathList) {
+            countList << countChildren(dirPath);
+        }
+
+        QStringList changedList;
+
+        m_mutex.lock();
+
+        for (int i = 0; i < pathList.count(); ++i) {
+            auto it = m_pending.find(pathList.at(i));
+
+            /// removed or requested again for a newer mtime while the batch was running
+            if (it == m_pending.end() || it.value() != mtimeList.at(i))
+                continue;
+
+            m_pending.erase(it);
+
+            if (m_cache.count() >= CHILD_COUNT_CACHE_MAX_COUNT)
+                m_cache.clear();
+
+            m_cache[pathList.at(i)] = CacheEntry{mtimeList.at(i), countList.at(i)};
+
+            changedList << pathList.at(i);
+        }
+
+        m_mutex.unlock();
+
+        for (const QString &dirPath : changedList) {
+            emit childCountChanged(dirPath);
+        }
+    }
+}
+
+/// the same entries FileUtils::filesCount() counts, without building their names
+qint64 ChildCountManager::countChildren(const QString &dirPath)
+{
+    int fd = ::open(QFile::encodeName(dirPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+
+        return 0;
+    }
+
+    /// a directory reached by another path, e.g. after a rename or through a
+    /// bind mount, isn't read again while its mtime stays the same
+    const FileKey key(st.st_dev, st.st_ino);
+    auto it = m_inodeCache.constFind(key);
+
+    if (it != m_inodeCache.constEnd() && it->mtimeSec == qint64(st.st_mtim.tv_sec)
+            && it->mtimeNsec == qint64(st.st_mtim.tv_nsec)) {
+        ::close(fd);
+
+        return it->count;
+    }
+
+    DIR *dir = ::fdopendir(fd);
+
+    if (!dir) {
+        ::close(fd);
+
+        return 0;
+    }
+
+    qint64 count = 0;
+
+    while (const struct dirent *entry = ::readdir(dir)) {
+        const char *name = entry->d_name;
+
+        if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+            continue;
+
+        ++count;
+    }
+
+    ::closedir(dir);
+
+    if (m_inodeCache.count() >= CHILD_COUNT_CACHE_MAX_COUNT)
+        m_inodeCache.clear();
+
+    m_inodeCache[key] = InodeEntry{qint64(st.st_mtim.tv_sec), qint64(st.st_mtim.tv_nsec), count};
+
+    return count;
+}
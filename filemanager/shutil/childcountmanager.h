@@ -0,0 +1,58 @@
+#ifndef CHILDCOUNTMANAGER_H
+#define CHILDCOUNTMANAGER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+class ChildCountManager : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit ChildCountManager(QObject *parent = 0);
+    ~ChildCountManager();
+
+    /// \a mtime is the one the caller knows, in msecs since the epoch
+    bool childCount(const QString &dirPath, qint64 mtime, qint64 *count);
+    void requestChildCount(const QString &dirPath, qint64 mtime);
+    void removeChildCount(const QString &dirPath);
+
+signals:
+    void childCountChanged(const QString &dirPath);
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    typedef QPair<quint64, quint64> FileKey;
+
+    struct CacheEntry
+    {
+        qint64 mtime;
+        qint64 count;
+    };
+
+    struct InodeEntry
+    {
+        qint64 mtimeSec;
+        qint64 mtimeNsec;
+        qint64 count;
+    };
+
+    qint64 countChildren(const QString &dirPath);
+
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QList<QString> m_taskList;
+    QHash<QString, qint64> m_pending;
+    QHash<QString, CacheEntry> m_cache;
+    /// only touched by the worker
+    QHash<FileKey, InodeEntry> m_inodeCache;
+    bool m_quit = false;
+};
+
+#endif // CHILDCOUNTMANAGER_H
@@ -0,0 +1,389 @@
+#include "contentsearchengine.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QFile>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define CONTENT_SEARCH_MAX_FILE_SIZE (64 * 1024 * 1024)
+/// a NUL byte in this many leading bytes marks a file as binary
+#define CONTENT_SEARCH_SNIFF_SIZE 8192
+#define CONTENT_SEARCH_CHUNK_SIZE (256 * 1024)
+#define CONTENT_SEARCH_BATCH_SIZE 32
+#define CONTENT_SEARCH_SNIPPET_BEFORE 40
+#define CONTENT_SEARCH_SNIPPET_AFTER 80
+
+class ContentWalkTask : public QRunnable
+{
+public:
+    ContentWalkTask(ContentSearchEngine *engine, const QByteArray &dirPath)
+        : engine(engine)
+        , dirPath(dirPath)
+    {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        engine->walk(dirPath);
+        engine->finishTask();
+    }
+
+private:
+    ContentSearchEngine *engine;
+    QByteArray dirPath;
+};
+
+class ContentScanTask : public QRunnable
+{
+public:
+    ContentScanTask(ContentSearchEngine *engine, const QVector<QByteArray> &filePaths)
+        : engine(engine)
+        , filePaths(filePaths)
+    {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        engine->scan(filePaths);
+        engine->finishTask();
+    }
+
+private:
+    ContentSearchEngine *engine;
+    QVector<QByteArray> filePaths;
+};
+
+static inline char foldCase(char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+/// short only at the end of the file, -1 on an error
+static qint64 readAt(int fd, char *data, qint64 size, qint64 offset)
+{
+    qint64 total = 0;
+
+    while (total < size) {
+        const ssize_t ret = ::pread(fd, data + total, size - total, offset + total);
+
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+
+            return -1;
+        }
+
+        if (ret == 0)
+            break;
+
+        total += ret;
+    }
+
+    return total;
+}
+
+static bool equalsFolded(const char *data, const char *keyword, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        if (foldCase(data[i]) != keyword[i])
+            return false;
+    }
+
+    return true;
+}
+
+ContentSearchEngine::ContentSearchEngine(const QString &keyword, bool includeHidden)
+    : m_includeHidden(includeHidden)
+{
+    const QByteArray &utf8 = keyword.toUtf8();
+
+    m_keyword.resize(utf8.size());
+
+    for (int i = 0; i < utf8.size(); ++i) {
+        m_keyword[i] = foldCase(utf8.at(i));
+    }
+
+    /// the scans wait on the disk most of the time
+    m_pool.setMaxThreadCount(qMax(4, QThread::idealThreadCount() * 2));
+}
+
+ContentSearchEngine::~ContentSearchEngine()
+{
+    stop();
+    m_pool.waitForDone();
+}
+
+void ContentSearchEngine::start(const QString &dirPath)
+{
+    if (m_keyword.isEmpty())
+        return;
+
+    startTask(new ContentWalkTask(this, QFile::encodeName(dirPath)));
+}
+
+void ContentSearchEngine::stop()
+{
+    m_stopped.storeRelease(1);
+
+    QMutexLocker locker(&m_mutex);
+
+    m_condition.wakeAll();
+}
+
+bool ContentSearchEngine::isStopped() const
+{
+    return m_stopped.loadAcquire();
+}
+
+bool ContentSearchEngine::takeHit(ContentSearchEngine::Hit *hit)
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (m_hits.isEmpty() && m_runningTasks > 0 && !isStopped())
+        m_condition.wait(&m_mutex);
+
+    if (m_hits.isEmpty() || isStopped())
+        return false;
+
+    *hit = m_hits.dequeue();
+
+    return true;
+}
+
+/// \a keyword has to be folded to lower case already. With SSE2, 16 positions
+/// are tested at once against the first and the last byte of the keyword and
+/// only the candidates are compared in full.
+const char *ContentSearchEngine::find(const char *begin, const char *end, const QByteArray &keyword)
+{
+    const int size = keyword.size();
+
+    if (size == 0 || end - begin < size)
+        return Q_NULLPTR;
+
+    const char *key = keyword.constData();
+    const char *last = end - size;
+    const char *pos = begin;
+
+#ifdef __SSE2__
+    const __m128i fold = _mm_set1_epi8(0x20);
+    const __m128i firstByte = _mm_set1_epi8(key[0] | 0x20);
+    const __m128i lastByte = _mm_set1_epi8(key[size - 1] | 0x20);
+
+    for (; last - pos >= 15; pos += 16) {
+        const __m128i blockFirst = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)), fold);
+        const __m128i blockLast = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + size - 1)), fold);
+        uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstByte),
+                                                    _mm_cmpeq_epi8(blockLast, lastByte)));
+
+        while (mask) {
+            const char *candidate = pos + __builtin_ctz(mask);
+
+            if (equalsFolded(candidate, key, size))
+                return candidate;
+
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; pos <= last; ++pos) {
+        if (foldCase(*pos) == key[0] && equalsFolded(pos, key, size))
+            return pos;
+    }
+
+    return Q_NULLPTR;
+}
+
+void ContentSearchEngine::walk(const QByteArray &dirPath)
+{
+    if (isStopped())
+        return;
+
+    DIR *dir = ::opendir(dirPath.constData());
+
+    if (!dir)
+        return;
+
+    QVector<QByteArray> filePaths;
+
+    while (struct dirent *entry = ::readdir(dir)) {
+        if (isStopped())
+            break;
+
+        const char *name = entry->d_name;
+
+        if (name[0] == '.') {
+            if (name[1] == '\0' || (name[1] == '.' && name[2] == '\0') || !m_includeHidden)
+                continue;
+        }
+
+        unsigned char type = entry->d_type;
+
+        if (type == DT_UNKNOWN) {
+            struct stat st;
+
+            if (::fstatat(::dirfd(dir), name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                continue;
+
+            type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+        }
+
+        const QByteArray &path = dirPath.endsWith('/') ? dirPath + name : dirPath + '/' + name;
+
+        if (type == DT_DIR) {
+            startTask(new ContentWalkTask(this, path));
+        } else if (type == DT_REG) {
+            filePaths << path;
+
+            if (filePaths.count() >= CONTENT_SEARCH_BATCH_SIZE) {
+                startTask(new ContentScanTask(this, filePaths));
+                filePaths.clear();
+            }
+        }
+    }
+
+    ::closedir(dir);
+
+    if (!filePaths.isEmpty() && !isStopped())
+        startTask(new ContentScanTask(this, filePaths));
+}
+
+void ContentSearchEngine::scan(const QVector<QByteArray> &filePaths)
+{
+    /// the end of a chunk is kept in front of the next one, a match across
+    /// the two is still found
+    QByteArray buffer(m_keyword.size() - 1 + CONTENT_SEARCH_CHUNK_SIZE, Qt::Uninitialized);
+
+    for (const QByteArray &filePath : filePaths) {
+        if (isStopped())
+            return;
+
+        scanFile(filePath, buffer);
+    }
+}
+
+/// the file is read, not mapped: one that's truncated meanwhile just ends
+/// earlier instead of faulting
+void ContentSearchEngine::scanFile(const QByteArray &filePath, QByteArray &buffer)
+{
+    int fd = ::open(filePath.constData(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+
+    if (fd < 0)
+        return;
+
+    struct stat st;
+
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 || st.st_size > CONTENT_SEARCH_MAX_FILE_SIZE) {
+        ::close(fd);
+
+        return;
+    }
+
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    const int overlap = m_keyword.size() - 1;
+    char *data = buffer.data();
+    qint64 offset = 0;
+    int carried = 0;
+    qint64 matchOffset = -1;
+
+    while (!isStopped()) {
+        const qint64 size = readAt(fd, data + carried, CONTENT_SEARCH_CHUNK_SIZE, offset);
+
+        if (size <= 0)
+            break;
+
+        if (offset == 0 && ::memchr(data, '\0', qMin(size, qint64(CONTENT_SEARCH_SNIFF_SIZE))))
+            break;
+
+        const char *chunkEnd = data + carried + size;
+
+        if (const char *match = find(data, chunkEnd, m_keyword)) {
+            matchOffset = offset - carried + (match - data);
+            break;
+        }
+
+        if (size < CONTENT_SEARCH_CHUNK_SIZE)
+            break;
+
+        offset += size;
+        carried = qMin(overlap, int(chunkEnd - data));
+        ::memmove(data, chunkEnd - carried, carried);
+    }
+
+    if (matchOffset < 0) {
+        ::close(fd);
+
+        return;
+    }
+
+    /// the text around the match is read on its own, it may span two chunks
+    const qint64 snippetOffset = qMax(qint64(0), matchOffset - CONTENT_SEARCH_SNIPPET_BEFORE);
+    QByteArray snippetData(matchOffset - snippetOffset + m_keyword.size() + CONTENT_SEARCH_SNIPPET_AFTER, Qt::Uninitialized);
+    const qint64 snippetSize = readAt(fd, snippetData.data(), snippetData.size(), snippetOffset);
+
+    ::close(fd);
+
+    const char *begin = snippetData.constData();
+    const char *end = begin + snippetSize;
+    const char *match = begin + (matchOffset - snippetOffset);
+
+    /// changed since it was searched
+    if (snippetSize < 0 || match + m_keyword.size() > end)
+        return;
+
+    const char *snippetBegin = begin;
+    const char *snippetEnd = end;
+
+    for (const char *pos = match; pos > snippetBegin; --pos) {
+        if (pos[-1] == '\n') {
+            snippetBegin = pos;
+            break;
+        }
+    }
+
+    if (const char *newLine = static_cast<const char*>(::memchr(match, '\n', snippetEnd - match)))
+        snippetEnd = newLine;
+
+    /// don't cut an UTF-8 sequence at either side
+    while (snippetBegin < match && (uchar(*snippetBegin) & 0xc0) == 0x80)
+        ++snippetBegin;
+
+    while (snippetEnd < end && snippetEnd > match && (uchar(*snippetEnd) & 0xc0) == 0x80)
+        --snippetEnd;
+
+    Hit hit;
+
+    hit.filePath = QFile::decodeName(filePath);
+    hit.snippet = QString::fromUtf8(snippetBegin, snippetEnd - snippetBegin).simplified();
+
+    QMutexLocker locker(&m_mutex);
+
+    m_hits.enqueue(hit);
+    m_condition.wakeAll();
+}
+
+void ContentSearchEngine::startTask(QRunnable *task)
+{
+    m_mutex.lock();
+    ++m_runningTasks;
+    m_mutex.unlock();
+
+    m_pool.start(task);
+}
+
+void ContentSearchEngine::finishTask()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (--m_runningTasks == 0)
+        m_condition.wakeAll();
+}
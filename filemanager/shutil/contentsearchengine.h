@@ -0,0 +1,60 @@
+#ifndef CONTENTSEARCHENGINE_H
+#define CONTENTSEARCHENGINE_H
+
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QVector>
+
+/// Looks for a keyword inside the regular files below a directory. The walk
+/// and the scans run on the engine's own pool, files are read in chunks and
+/// searched for the keyword, ignoring the case of ASCII letters. Files that
+/// look binary or are larger than CONTENT_SEARCH_MAX_FILE_SIZE are skipped.
+class ContentSearchEngine
+{
+public:
+    struct Hit
+    {
+        QString filePath;
+        /// the text around the first match, on one line
+        QString snippet;
+    };
+
+    explicit ContentSearchEngine(const QString &keyword, bool includeHidden = false);
+    ~ContentSearchEngine();
+
+    void start(const QString &dirPath);
+    void stop();
+
+    bool isStopped() const;
+
+    /// blocks until a hit is found, false once the search is done or stopped
+    bool takeHit(Hit *hit);
+
+    static const char *find(const char *begin, const char *end, const QByteArray &keyword);
+
+private:
+    void walk(const QByteArray &dirPath);
+    void scan(const QVector<QByteArray> &filePaths);
+    void scanFile(const QByteArray &filePath, QByteArray &buffer);
+    void startTask(QRunnable *task);
+    void finishTask();
+
+    QThreadPool m_pool;
+    QAtomicInt m_stopped;
+
+    QByteArray m_keyword;
+    bool m_includeHidden;
+
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QQueue<Hit> m_hits;
+    int m_runningTasks = 0;
+
+    friend class ContentWalkTask;
+    friend class ContentScanTask;
+};
+
+#endif // CONTENTSEARCHENGINE_H
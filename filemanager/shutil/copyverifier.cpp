@@ -0,0 +1,338 @@
+#include "copyverifier.h"
+
+#include <QRunnable>
+#include <QFile>
+#include <QDebug>
+
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+
+/// blocks the copy may run ahead of the hashing
+#define COPY_VERIFY_RING_SIZE 8
+#define COPY_VERIFY_READ_SIZE (1024 * 1024)
+
+static const quint64 Prime1 = Q_UINT64_C(0x9E3779B185EBCA87);
+static const quint64 Prime2 = Q_UINT64_C(0xC2B2AE3D27D4EB4F);
+static const quint64 Prime3 = Q_UINT64_C(0x165667B19E3779F9);
+static const quint64 Prime4 = Q_UINT64_C(0x85EBCA77C2B2AE63);
+static const quint64 Prime5 = Q_UINT64_C(0x27D4EB2F165667C5);
+
+static inline quint64 rotateLeft(quint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline quint64 read64(const char *data)
+{
+    quint64 value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+static inline quint32 read32(const char *data)
+{
+    quint32 value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+static inline quint64 round64(quint64 acc, quint64 input)
+{
+    return rotateLeft(acc + input * Prime2, 31) * Prime1;
+}
+
+static inline quint64 mergeRound64(quint64 acc, quint64 value)
+{
+    return (acc ^ round64(0, value)) * Prime1 + Prime4;
+}
+
+/// streaming XXH64 with a seed of 0, the input is taken in stripes of 32 bytes
+struct CopyVerifier::HashState
+{
+    quint64 acc[4];
+    quint64 totalSize;
+    char tail[32];
+    int tailSize;
+
+    void reset()
+    {
+        acc[0] = Prime1 + Prime2;
+        acc[1] = Prime2;
+        acc[2] = 0;
+        acc[3] = -Prime1;
+        totalSize = 0;
+        tailSize = 0;
+    }
+
+    void consumeStripe(const char *data)
+    {
+        for (int i = 0; i < 4; ++i) {
+            acc[i] = round64(acc[i], read64(data + i * 8));
+        }
+    }
+
+    void update(const char *data, qint64 size)
+    {
+        totalSize += size;
+
+        if (tailSize > 0) {
+            const int fill = qMin(qint64(32 - tailSize), size);
+
+            memcpy(tail + tailSize, data, fill);
+            tailSize += fill;
+            data += fill;
+            size -= fill;
+
+            if (tailSize < 32)
+                return;
+
+            consumeStripe(tail);
+            tailSize = 0;
+        }
+
+        for (; size >= 32; data += 32, size -= 32) {
+            consumeStripe(data);
+        }
+
+        memcpy(tail, data, size);
+        tailSize = size;
+    }
+
+    quint64 digest() const
+    {
+        quint64 hash;
+
+        if (totalSize >= 32) {
+            hash = rotateLeft(acc[0], 1) + rotateLeft(acc[1], 7) + rotateLeft(acc[2], 12) + rotateLeft(acc[3], 18);
+
+            for (int i = 0; i < 4; ++i) {
+                hash = mergeRound64(hash, acc[i]);
+            }
+        } else {
+            hash = Prime5;
+        }
+
+        hash += totalSize;
+
+        const char *pos = tail;
+        const char *end = tail + tailSize;
+
+        for (; pos + 8 <= end; pos += 8) {
+            hash = rotateLeft(hash ^ round64(0, read64(pos)), 27) * Prime1 + Prime4;
+        }
+
+        if (pos + 4 <= end) {
+            hash = rotateLeft(hash ^ (quint64(read32(pos)) * Prime1), 23) * Prime2 + Prime3;
+            pos += 4;
+        }
+
+        for (; pos < end; ++pos) {
+            hash = rotateLeft(hash ^ (uchar(*pos) * Prime5), 11) * Prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+};
+
+class CopyHashTask : public QRunnable
+{
+public:
+    explicit CopyHashTask(CopyVerifier *verifier)
+        : verifier(verifier)
+    {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        verifier->hashBlocks();
+    }
+
+private:
+    CopyVerifier *verifier;
+};
+
+CopyVerifier::CopyVerifier(int blockSize)
+    : m_state(new HashState)
+    , m_blocks(COPY_VERIFY_RING_SIZE)
+    , m_blockSizes(COPY_VERIFY_RING_SIZE, 0)
+{
+    for (QByteArray &block : m_blocks) {
+        block.resize(blockSize);
+    }
+
+    m_pool.setMaxThreadCount(1);
+}
+
+CopyVerifier::~CopyVerifier()
+{
+    finish();
+    m_pool.waitForDone();
+
+    delete m_state;
+}
+
+void CopyVerifier::start()
+{
+    finish();
+
+    m_state->reset();
+    m_head = 0;
+    m_count = 0;
+    m_running = true;
+    m_finishing = false;
+
+    m_pool.start(new CopyHashTask(this));
+}
+
+void CopyVerifier::feed(const char *data, qint64 size)
+{
+    if (!m_running)
+        return;
+
+    while (size > 0) {
+        QMutexLocker locker(&m_mutex);
+
+        while (m_count == m_blocks.count())
+            m_notFull.wait(&m_mutex);
+
+        locker.unlock();
+
+        /// the slot at m_head isn't touched by the hashing before m_count counts it
+        QByteArray &block = m_blocks[m_head];
+        const int blockSize = qMin(qint64(block.size()), size);
+
+        memcpy(block.data(), data, blockSize);
+        m_blockSizes[m_head] = blockSize;
+        data += blockSize;
+        size -= blockSize;
+
+        locker.relock();
+        m_head = (m_head + 1) % m_blocks.count();
+        ++m_count;
+        m_notEmpty.wakeOne();
+    }
+}
+
+void CopyVerifier::feedZeros(qint64 size)
+{
+    if (!m_running || size <= 0)
+        return;
+
+    const QByteArray zeros(qMin(qint64(m_blocks.first().size()), size), '\0');
+
+    for (; size > 0; size -= zeros.size()) {
+        feed(zeros.constData(), qMin(qint64(zeros.size()), size));
+    }
+}
+
+quint64 CopyVerifier::finish()
+{
+    if (!m_running)
+        return m_state->digest();
+
+    m_mutex.lock();
+    m_finishing = true;
+    m_notEmpty.wakeOne();
+    m_mutex.unlock();
+
+    m_pool.waitForDone();
+    m_running = false;
+
+    return m_state->digest();
+}
+
+bool CopyVerifier::isRunning() const
+{
+    return m_running;
+}
+
+bool CopyVerifier::hashFile(int fd, quint64 *hash)
+{
+    HashState state;
+    QByteArray buffer(COPY_VERIFY_READ_SIZE, Qt::Uninitialized);
+    qint64 offset = 0;
+
+    state.reset();
+
+    while (true) {
+        const ssize_t size = ::pread(fd, buffer.data(), buffer.size(), offset);
+
+        if (size < 0) {
+            if (errno == EINTR)
+                continue;
+
+            qDebug() << "read for the verification failed:" << strerror(errno);
+
+            return false;
+        }
+
+        if (size == 0)
+            break;
+
+        state.update(buffer.constData(), size);
+        offset += size;
+    }
+
+    *hash = state.digest();
+
+    return true;
+}
+
+bool CopyVerifier::hashFileFromDisk(const QString &filePath, quint64 *hash)
+{
+    int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        qDebug() << "couldn't open" << filePath << "for the verification:" << strerror(errno);
+
+        return false;
+    }
+
+    /// dirty pages aren't dropped, they have to be written first
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    bool ok = hashFile(fd, hash);
+
+    /// the pages read for the check aren't worth keeping either
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+
+    return ok;
+}
+
+void CopyVerifier::hashBlocks()
+{
+    int tail = 0;
+
+    while (true) {
+        QMutexLocker locker(&m_mutex);
+
+        while (m_count == 0 && !m_finishing)
+            m_notEmpty.wait(&m_mutex);
+
+        if (m_count == 0)
+            return;
+
+        locker.unlock();
+
+        m_state->update(m_blocks.at(tail).constData(), m_blockSizes.at(tail));
+        tail = (tail + 1) % m_blocks.count();
+
+        locker.relock();
+        --m_count;
+        m_notFull.wakeOne();
+    }
+}
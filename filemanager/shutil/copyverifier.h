@@ -0,0 +1,56 @@
+#ifndef COPYVERIFIER_H
+#define COPYVERIFIER_H
+
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+
+/// Checks a copy against its source without reading the source twice. The
+/// copy loop hands every block it writes to feed(), a thread of the verifier
+/// takes them from a bounded ring and hashes them (XXH64), so the source is
+/// hashed from the same reads the copy does. The target is hashed afterwards
+/// with hashFile(), after its pages are dropped, so the disk is what's read.
+class CopyVerifier
+{
+public:
+    explicit CopyVerifier(int blockSize);
+    ~CopyVerifier();
+
+    /// starts hashing a new file, feed() does nothing before this
+    void start();
+    void feed(const char *data, qint64 size);
+    /// holes of a sparse file read as zeros
+    void feedZeros(qint64 size);
+    /// waits for the blocks fed so far, the hash of all of them
+    quint64 finish();
+
+    bool isRunning() const;
+
+    /// the hash of the whole file, \a fd is read with pread
+    static bool hashFile(int fd, quint64 *hash);
+    /// drops the cached pages of \a filePath and hashes it from the disk
+    static bool hashFileFromDisk(const QString &filePath, quint64 *hash);
+
+private:
+    struct HashState;
+
+    void hashBlocks();
+
+    QThreadPool m_pool;
+    HashState *m_state;
+
+    QMutex m_mutex;
+    QWaitCondition m_notFull;
+    QWaitCondition m_notEmpty;
+    QVector<QByteArray> m_blocks;
+    QVector<int> m_blockSizes;
+    int m_head = 0;
+    int m_count = 0;
+    bool m_running = false;
+    bool m_finishing = false;
+
+    friend class CopyHashTask;
+};
+
+#endif // COPYVERIFIER_H
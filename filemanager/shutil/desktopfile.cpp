@@ -1,9 +1,255 @@
 #include "desktopfile.h"
-#include "properties.h"
+
+#include "widgets/singleton.h"
+
 #include <QFile>
-#include <QSettings>
+#include <QHash>
+#include <QMutex>
+#include <QLocale>
 #include <QDebug>
 
+#include <sys/stat.h>
+
+#define DESKTOP_ENTRY_CACHE_MAX_COUNT 4096
+
+namespace {
+
+/**
+ * @brief Parsed values of the [Desktop Entry] group, shared by every
+ * DesktopFile constructed for the same unchanged file
+ */
+struct DesktopEntry {
+    qint64 mtimeSec = -1;
+    qint64 mtimeNsec = -1;
+    qint64 size = -1;
+    QString name;
+    QString localName;
+    QString exec;
+    QString icon;
+    QString type;
+    QStringList categories;
+    QStringList mimeType;
+};
+
+class DesktopEntryCache {
+public:
+    bool find(const QString &fileName, const struct stat &st, DesktopEntry *entry) {
+        QMutexLocker locker(&m_mutex);
+
+        auto it = m_entries.constFind(fileName);
+
+        if (it == m_entries.constEnd() || it->size != qint64(st.st_size)
+                || it->mtimeSec != qint64(st.st_mtim.tv_sec)
+                || it->mtimeNsec != qint64(st.st_mtim.tv_nsec)) {
+            return false;
+        }
+
+        *entry = it.value();
+
+        return true;
+    }
+
+    void insert(const QString &fileName, const DesktopEntry &entry) {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_entries.count() >= DESKTOP_ENTRY_CACHE_MAX_COUNT && !m_entries.contains(fileName)) {
+            m_entries.clear();
+        }
+
+        m_entries.insert(fileName, entry);
+    }
+
+private:
+    QMutex m_mutex;
+    QHash<QString, DesktopEntry> m_entries;
+};
+
+/**
+ * @brief Returns the locale suffixes to look for in "Name[...]" keys, most
+ * specific first (lang_COUNTRY@MODIFIER, lang_COUNTRY, lang@MODIFIER, lang)
+ */
+QList<QByteArray> localeKeys() {
+    QList<QByteArray> keys;
+
+    const QByteArray &locale = QLocale::system().name().toLatin1();
+    int modifierIndex = locale.indexOf('@');
+    const QByteArray &modifier = modifierIndex >= 0 ? locale.mid(modifierIndex) : QByteArray();
+    const QByteArray &langCountry = modifierIndex >= 0 ? locale.left(modifierIndex) : locale;
+    int countryIndex = langCountry.indexOf('_');
+    const QByteArray &lang = countryIndex >= 0 ? langCountry.left(countryIndex) : langCountry;
+
+    if (!modifier.isEmpty()) {
+        keys << langCountry + modifier;
+    }
+
+    keys << langCountry;
+
+    if (countryIndex >= 0) {
+        if (!modifier.isEmpty()) {
+            keys << lang + modifier;
+        }
+
+        keys << lang;
+    }
+
+    return keys;
+}
+
+inline bool isSpace(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+inline bool keyEquals(const char *key, int keyLength, const char *name) {
+    int nameLength = qstrlen(name);
+
+    return keyLength == nameLength && qstrncmp(key, name, nameLength) == 0;
+}
+
+QStringList splitList(const char *value, int length) {
+    QStringList list;
+    int begin = 0;
+
+    for (int i = 0; i <= length; ++i) {
+        if (i < length && value[i] != ';') {
+            continue;
+        }
+
+        QByteArray item = QByteArray::fromRawData(value + begin, i - begin);
+
+        // Keep the historical behavior of dropping any inner space
+        if (item.contains(' ')) {
+            item = QByteArray(item).replace(' ', QByteArray());
+        }
+
+        list << QString::fromUtf8(item);
+        begin = i + 1;
+    }
+
+    return list;
+}
+
+/**
+ * @brief Parses the [Desktop Entry] group of a desktop file in a single pass
+ * over its contents, only the values that are used get converted to QString
+ * @return true if the group was found
+ */
+bool parseDesktopEntry(const char *data, qint64 size, DesktopEntry *entry) {
+    static const QList<QByteArray> locales = localeKeys();
+    int localNamePriority = locales.count();
+    bool inGroup = false;
+    bool groupFound = false;
+    bool hasType = false;
+    const char *end = data + size;
+    const char *line = data;
+
+    while (line < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        const char *begin = line;
+        const char *last = lineEnd;
+
+        line = lineEnd + 1;
+
+        while (begin < last && isSpace(*begin)) {
+            ++begin;
+        }
+
+        while (last > begin && isSpace(*(last - 1))) {
+            --last;
+        }
+
+        if (begin == last || *begin == '#') {
+            continue;
+        }
+
+        if (*begin == '[') {
+            // The desktop entry group must come first, nothing after it is of interest
+            if (groupFound) {
+                break;
+            }
+
+            inGroup = keyEquals(begin, last - begin, "[Desktop Entry]");
+            groupFound = inGroup;
+
+            continue;
+        }
+
+        if (!inGroup) {
+            continue;
+        }
+
+        const char *equal = static_cast<const char *>(memchr(begin, '=', last - begin));
+
+        if (!equal) {
+            continue;
+        }
+
+        const char *keyEnd = equal;
+
+        while (keyEnd > begin && isSpace(*(keyEnd - 1))) {
+            --keyEnd;
+        }
+
+        const char *value = equal + 1;
+
+        while (value < last && isSpace(*value)) {
+            ++value;
+        }
+
+        const int keyLength = keyEnd - begin;
+        const int valueLength = last - value;
+
+        if (keyEquals(begin, keyLength, "Name")) {
+            entry->name = QString::fromUtf8(value, valueLength);
+        } else if (keyLength > 6 && qstrncmp(begin, "Name[", 5) == 0 && begin[keyLength - 1] == ']') {
+            const QByteArray locale = QByteArray::fromRawData(begin + 5, keyLength - 6);
+            int priority = locales.indexOf(locale);
+
+            if (priority >= 0 && priority < localNamePriority) {
+                entry->localName = QString::fromUtf8(value, valueLength);
+                localNamePriority = priority;
+            }
+        } else if (keyEquals(begin, keyLength, "Exec")) {
+            entry->exec = QString::fromUtf8(value, valueLength);
+        } else if (keyEquals(begin, keyLength, "Icon")) {
+            entry->icon = QString::fromUtf8(value, valueLength);
+        } else if (keyEquals(begin, keyLength, "Type")) {
+            entry->type = QString::fromUtf8(value, valueLength);
+            hasType = true;
+        } else if (keyEquals(begin, keyLength, "Categories")) {
+            entry->categories = splitList(value, valueLength);
+        } else if (keyEquals(begin, keyLength, "MimeType")) {
+            entry->mimeType = splitList(value, valueLength);
+        }
+    }
+
+    if (!hasType) {
+        entry->type = "Application";
+    }
+
+    if (entry->localName.isEmpty()) {
+        entry->localName = entry->name;
+    }
+
+    if (entry->categories.isEmpty()) {
+        entry->categories << QString();
+    }
+
+    if (entry->mimeType.isEmpty()) {
+        entry->mimeType << QString();
+    }
+
+    return groupFound;
+}
+
+}
+
+#define desktopEntryCache Singleton<DesktopEntryCache>::instance()
+
 /**
  * @brief Loads desktop file
  * @param fileName
@@ -14,28 +260,42 @@ DesktopFile::DesktopFile(const QString &fileName) {
     m_fileName = fileName;
 
     // File validity
-    if (!QFile::exists(fileName)) {
+    struct stat st;
+
+    if (fileName.isEmpty() || ::stat(QFile::encodeName(fileName).constData(), &st) != 0) {
         return;
     }
 
-    QSettings settings(fileName, QSettings::IniFormat);
-    settings.beginGroup("Desktop Entry");
-    // Loads .desktop file (read from 'Desktop Entry' group)
-    Properties desktop(fileName, "Desktop Entry");
-    m_name = desktop.value("Name", settings.value("Name")).toString();
+    DesktopEntry entry;
+
+    if (!desktopEntryCache->find(fileName, st, &entry)) {
+        QFile file(fileName);
 
+        if (!file.open(QIODevice::ReadOnly)) {
+            return;
+        }
 
-    QString localKey = QString("Name[%1]").arg(QLocale::system().name());
-    if (desktop.contains(localKey)){
-        m_localName = desktop.value(localKey, m_name).toString();
-    }else{
-        m_localName = m_name;
+        // Read rather than map: a file truncated while it's parsed would
+        // raise SIGBUS in a mapping
+        const QByteArray &data = file.readAll();
+
+        parseDesktopEntry(data.constData(), data.size(), &entry);
+
+        entry.mtimeSec = st.st_mtim.tv_sec;
+        entry.mtimeNsec = st.st_mtim.tv_nsec;
+        entry.size = st.st_size;
+
+        desktopEntryCache->insert(fileName, entry);
     }
-    m_exec = desktop.value("Exec", settings.value("Exec")).toString();
-    m_icon = desktop.value("Icon", settings.value("Icon")).toString();
-    m_type = desktop.value("Type", settings.value("Type", "Application")).toString();
-    m_categories = desktop.value("Categories", settings.value("Categories").toString()).toString().remove(" ").split(";");
-    m_mimeType = desktop.value("MimeType", settings.value("MimeType").toString()).toString().remove(" ").split(";");
+
+    m_name = entry.name;
+    m_localName = entry.localName;
+    m_exec = entry.exec;
+    m_icon = entry.icon;
+    m_type = entry.type;
+    m_categories = entry.categories;
+    m_mimeType = entry.mimeType;
+
     // Fix categories
     if (m_categories.first().compare("") == 0) {
         m_categories.removeFirst();
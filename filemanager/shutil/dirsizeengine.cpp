@@ -0,0 +1,270 @@
+#include "dirsizeengine.h"
+
+#include "widgets/singleton.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QHash>
+#include <QVector>
+#include <QFile>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define DIR_SIZE_CACHE_MAX_COUNT 200000
+
+struct DirSizeEngine::DirRecord
+{
+    struct HardLink
+    {
+        FileKey key;
+        qint64 size;
+        qint64 diskSize;
+    };
+
+    qint64 mtimeSec = 0;
+    qint64 mtimeNsec = 0;
+    qint64 size = 0;
+    qint64 diskSize = 0;
+    qint64 fileCount = 0;
+    QVector<HardLink> hardLinks;
+    QVector<QByteArray> subDirs;
+};
+
+/// Directories are keyed by (dev, inode) and validated by their mtime. A directory
+/// whose mtime is unchanged is not read again, only its sub directories are
+/// revisited, so a re-walk only touches the subtrees that actually changed.
+/// In-place growth of a file does not bump its parent's mtime and is therefore
+/// only picked up once that directory changes.
+class DirSizeCache
+{
+public:
+    bool find(const DirSizeEngine::FileKey &key, const struct stat &st, DirSizeEngine::DirRecord *record)
+    {
+        QMutexLocker locker(&mutex);
+
+        auto it = records.constFind(key);
+
+        if (it == records.constEnd())
+            return false;
+
+        if (it->mtimeSec != qint64(st.st_mtim.tv_sec) || it->mtimeNsec != qint64(st.st_mtim.tv_nsec))
+            return false;
+
+        *record = it.value();
+
+        return true;
+    }
+
+    void insert(const DirSizeEngine::FileKey &key, const DirSizeEngine::DirRecord &record)
+    {
+        QMutexLocker locker(&mutex);
+
+        if (records.count() >= DIR_SIZE_CACHE_MAX_COUNT && !records.contains(key))
+            records.clear();
+
+        records.insert(key, record);
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&mutex);
+
+        records.clear();
+    }
+
+private:
+    QMutex mutex;
+    QHash<DirSizeEngine::FileKey, DirSizeEngine::DirRecord> records;
+};
+
+#define dirSizeCache Singleton<DirSizeCache>::instance()
+
+class DirSizeTask : public QRunnable
+{
+public:
+    DirSizeTask(DirSizeEngine *engine, const QByteArray &dirPath)
+        : engine(engine)
+        , dirPath(dirPath)
+    {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        engine->walk(dirPath);
+    }
+
+private:
+    DirSizeEngine *engine;
+    QByteArray dirPath;
+};
+
+DirSizeEngine::DirSizeEngine()
+{
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+}
+
+DirSizeEngine::~DirSizeEngine()
+{
+    stop();
+    m_pool.waitForDone();
+}
+
+void DirSizeEngine::start(const QString &filePath)
+{
+    const QByteArray &path = QFile::encodeName(filePath);
+    struct stat st;
+
+    if (::lstat(path.constData(), &st) != 0)
+        return;
+
+    if (S_ISDIR(st.st_mode)) {
+        m_pool.start(new DirSizeTask(this, path));
+
+        return;
+    }
+
+    DirRecord record;
+
+    if (st.st_nlink > 1) {
+        record.hardLinks.append({FileKey(st.st_dev, st.st_ino), st.st_size, qint64(st.st_blocks) * 512});
+    } else {
+        record.size = st.st_size;
+        record.diskSize = qint64(st.st_blocks) * 512;
+        record.fileCount = 1;
+    }
+
+    addRecord(record);
+}
+
+bool DirSizeEngine::waitForFinished(int msecs)
+{
+    return m_pool.waitForDone(msecs);
+}
+
+void DirSizeEngine::stop()
+{
+    m_stopped.storeRelease(1);
+}
+
+bool DirSizeEngine::isStopped() const
+{
+    return m_stopped.loadAcquire();
+}
+
+DirSizeEngine::Result DirSizeEngine::result() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_result;
+}
+
+void DirSizeEngine::clearCache()
+{
+    dirSizeCache->clear();
+}
+
+void DirSizeEngine::addRecord(const DirSizeEngine::DirRecord &record)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_result.size += record.size;
+    m_result.diskSize += record.diskSize;
+    m_result.fileCount += record.fileCount;
+
+    for (const DirRecord::HardLink &link : record.hardLinks) {
+        if (m_hardLinks.contains(link.key))
+            continue;
+
+        m_hardLinks.insert(link.key);
+        m_result.size += link.size;
+        m_result.diskSize += link.diskSize;
+        ++m_result.fileCount;
+    }
+}
+
+void DirSizeEngine::walk(const QByteArray &dirPath)
+{
+    if (isStopped())
+        return;
+
+    int fd = ::open(dirPath.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+
+    if (fd < 0)
+        return;
+
+    struct stat st;
+
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+
+        return;
+    }
+
+    const FileKey dirKey(st.st_dev, st.st_ino);
+    DirRecord record;
+
+    if (dirSizeCache->find(dirKey, st, &record)) {
+        ::close(fd);
+    } else {
+        DIR *dir = ::fdopendir(fd);
+
+        if (!dir) {
+            ::close(fd);
+
+            return;
+        }
+
+        record.mtimeSec = st.st_mtim.tv_sec;
+        record.mtimeNsec = st.st_mtim.tv_nsec;
+
+        while (struct dirent *entry = ::readdir(dir)) {
+            if (isStopped()) {
+                ::closedir(dir);
+
+                return;
+            }
+
+            const char *name = entry->d_name;
+
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+
+            struct stat entryStat;
+
+            if (::fstatat(::dirfd(dir), name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0)
+                continue;
+
+            if (S_ISLNK(entryStat.st_mode))
+                continue;
+
+            const qint64 diskSize = qint64(entryStat.st_blocks) * 512;
+
+            if (S_ISDIR(entryStat.st_mode)) {
+                record.size += entryStat.st_size;
+                record.diskSize += diskSize;
+                record.subDirs.append(QByteArray(name));
+            } else if (entryStat.st_nlink > 1) {
+                record.hardLinks.append({FileKey(entryStat.st_dev, entryStat.st_ino), entryStat.st_size, diskSize});
+            } else {
+                record.size += entryStat.st_size;
+                record.diskSize += diskSize;
+                ++record.fileCount;
+            }
+        }
+
+        ::closedir(dir);
+
+        dirSizeCache->insert(dirKey, record);
+    }
+
+    addRecord(record);
+
+    for (const QByteArray &name : record.subDirs) {
+        if (isStopped())
+            return;
+
+        m_pool.start(new DirSizeTask(this, dirPath + '/' + name));
+    }
+}
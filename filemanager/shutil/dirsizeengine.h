@@ -0,0 +1,50 @@
+#ifndef DIRSIZEENGINE_H
+#define DIRSIZEENGINE_H
+
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSet>
+#include <QPair>
+
+class DirSizeEngine
+{
+public:
+    struct Result
+    {
+        qint64 size = 0;
+        qint64 diskSize = 0;
+        qint64 fileCount = 0;
+    };
+
+    DirSizeEngine();
+    ~DirSizeEngine();
+
+    void start(const QString &filePath);
+    bool waitForFinished(int msecs = -1);
+    void stop();
+
+    bool isStopped() const;
+    Result result() const;
+
+    static void clearCache();
+
+private:
+    typedef QPair<quint64, quint64> FileKey;
+    struct DirRecord;
+
+    void addRecord(const DirRecord &record);
+    void walk(const QByteArray &dirPath);
+
+    QThreadPool m_pool;
+    QAtomicInt m_stopped;
+
+    mutable QMutex m_mutex;
+    Result m_result;
+    QSet<FileKey> m_hardLinks;
+
+    friend class DirSizeTask;
+    friend class DirSizeCache;
+};
+
+#endif // DIRSIZEENGINE_H
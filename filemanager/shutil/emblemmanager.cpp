@@ -0,0 +1,213 @@
+#include "emblemmanager.h"
+
+#include "../app/global.h"
+
+#include "widgets/singleton.h"
+
+#ifdef MENU_DIALOG_PLUGIN
+#include "mips/plugin/pluginmanagerapp.h"
+#endif
+
+#ifdef SW_LABEL
+#include "sw_label/filemanager.h"
+#endif
+
+#include <QStringList>
+
+#define EMBLEM_BATCH_SIZE 64
+#define EMBLEM_CACHE_MAX_COUNT 20000
+
+static QList<QIcon> labelIcons(const QString &filePath)
+{
+    QList<QIcon> icons;
+
+#ifdef SW_LABEL
+    std::string path = filePath.toStdString();
+    const QString &iconPath = QString::fromLocal8Bit(auto_add_emblem(const_cast<char*>(path.c_str())));
+
+    if (!iconPath.isEmpty() && iconPath != "No")
+        icons << QIcon(iconPath);
+#else
+    Q_UNUSED(filePath)
+#endif
+
+    return icons;
+}
+
+EmblemManager::EmblemManager(QObject *parent)
+    : QThread(parent)
+{
+    connect(this, &EmblemManager::legacyEmblemsRequested,
+            this, &EmblemManager::addLegacyEmblems, Qt::QueuedConnection);
+}
+
+EmblemManager::~EmblemManager()
+{
+    m_mutex.lock();
+    m_quit = true;
+    m_condition.wakeAll();
+    m_mutex.unlock();
+
+    wait();
+}
+
+bool EmblemManager::emblems(const QString &filePath, qint64 mtime, EmblemManager::Emblems *emblems)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_cache.constFind(filePath);
+
+    if (it == m_cache.constEnd() || it->mtime != mtime)
+        return false;
+
+    *emblems = it->emblems;
+
+    return true;
+}
+
+void EmblemManager::requestEmblems(const QString &filePath, qint64 mtime)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_pending.find(filePath);
+
+    if (it != m_pending.end() && it.value() == mtime)
+        return;
+
+    m_pending[filePath] = mtime;
+    m_taskList << filePath;
+    m_condition.wakeOne();
+
+    if (!isRunning())
+        start(QThread::LowPriority);
+}
+
+void EmblemManager::removeEmblems(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_pending.remove(filePath);
+
+    if (m_cache.remove(filePath) == 0)
+        return;
+
+    locker.unlock();
+
+    emit emblemChanged(filePath);
+}
+
+void EmblemManager::run()
+{
+    forever {
+        QStringList pathList;
+        QList<qint64> mtimeList;
+
+        m_mutex.lock();
+
+        while (!m_quit && m_taskList.isEmpty())
+            m_condition.wait(&m_mutex);
+
+        if (m_quit) {
+            m_mutex.unlock();
+
+            return;
+        }
+
+        /// newest requests first, they belong to the items that are on screen now
+        while (!m_taskList.isEmpty() && pathList.count() < EMBLEM_BATCH_SIZE) {
+            const QString &filePath = m_taskList.takeLast();
+            auto it = m_pending.constFind(filePath);
+
+            if (it == m_pending.constEnd() || pathList.contains(filePath))
+                continue;
+
+            pathList << filePath;
+            mtimeList << it.value();
+        }
+
+        m_mutex.unlock();
+
+        QList<QList<QIcon>> pluginIconsList;
+
+#ifdef MENU_DIALOG_PLUGIN
+        pluginManagerApp->fileAdditionalIcons(pathList, pluginIconsList);
+#endif
+
+        QList<QList<QIcon>> labelIconsList;
+
+        for (const QString &filePath : pathList) {
+            labelIconsList << labelIcons(filePath);
+        }
+
+        QStringList changedList;
+
+        m_mutex.lock();
+
+        for (int i = 0; i < pathList.count(); ++i) {
+            auto it = m_pending.find(pathList.at(i));
+
+            /// removed or requested again for a newer mtime while the batch was running
+            if (it == m_pending.end() || it.value() != mtimeList.at(i))
+                continue;
+
+            m_pending.erase(it);
+
+            if (m_cache.count() >= EMBLEM_CACHE_MAX_COUNT)
+                m_cache.clear();
+
+            /// a new entry, the legacy emblems of the old one are outdated too
+            CacheEntry entry;
+
+            entry.mtime = mtimeList.at(i);
+            entry.emblems.pluginIcons = pluginIconsList.value(i);
+            entry.emblems.labelIcons = labelIconsList.at(i);
+
+            m_cache.insert(pathList.at(i), entry);
+
+            changedList << pathList.at(i);
+        }
+
+        m_mutex.unlock();
+
+#ifdef MENU_DIALOG_PLUGIN
+        /// the plugins of the old interface aren't thread safe, they're asked
+        /// on the thread of this object and it tells about the changes then
+        if (!changedList.isEmpty() && pluginManagerApp->hasLegacyIconPlugins()) {
+            emit legacyEmblemsRequested(changedList);
+
+            continue;
+        }
+#endif
+
+        for (const QString &filePath : changedList) {
+            emit emblemChanged(filePath);
+        }
+    }
+}
+
+void EmblemManager::addLegacyEmblems(const QStringList &filePathList)
+{
+#ifdef MENU_DIALOG_PLUGIN
+    QList<QList<QIcon>> legacyIconsList;
+
+    pluginManagerApp->legacyFileAdditionalIcons(filePathList, legacyIconsList);
+
+    QMutexLocker locker(&m_mutex);
+
+    for (int i = 0; i < filePathList.count(); ++i) {
+        auto it = m_cache.find(filePathList.at(i));
+
+        if (it == m_cache.end() || it->hasLegacyEmblems)
+            continue;
+
+        it->emblems.pluginIcons << legacyIconsList.at(i);
+        it->hasLegacyEmblems = true;
+    }
+
+    locker.unlock();
+#endif
+
+    for (const QString &filePath : filePathList) {
+        emit emblemChanged(filePath);
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef EMBLEMMANAGER_H
+#define EMBLEMMANAGER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QStringList>
+#include <QIcon>
+
+class EmblemManager : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Emblems
+    {
+        QList<QIcon> pluginIcons;
+        QList<QIcon> labelIcons;
+    };
+
+    explicit EmblemManager(QObject *parent = 0);
+    ~EmblemManager();
+
+    bool emblems(const QString &filePath, qint64 mtime, Emblems *emblems);
+    void requestEmblems(const QString &filePath, qint64 mtime);
+    void removeEmblems(const QString &filePath);
+
+signals:
+    void emblemChanged(const QString &filePath);
+    void legacyEmblemsRequested(const QStringList &filePathList);
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private slots:
+    void addLegacyEmblems(const QStringList &filePathList);
+
+private:
+    struct CacheEntry
+    {
+        qint64 mtime;
+        Emblems emblems;
+        bool hasLegacyEmblems = false;
+    };
+
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QList<QString> m_taskList;
+    QHash<QString, qint64> m_pending;
+    QHash<QString, CacheEntry> m_cache;
+    bool m_quit = false;
+};
+
+#endif // EMBLEMMANAGER_H
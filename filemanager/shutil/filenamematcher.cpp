@@ -0,0 +1,226 @@
+#include "filenamematcher.h"
+#include "contentsearchengine.h"
+
+#include "chinese2pinyin.h"
+
+#include <QVarLengthArray>
+
+static inline char foldCase(char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+/// the start of the UTF-8 character after the one at \a pos
+static inline const char *nextChar(const char *pos, const char *end)
+{
+    ++pos;
+
+    while (pos < end && (uchar(*pos) & 0xc0) == 0x80)
+        ++pos;
+
+    return pos;
+}
+
+/// \a pos points behind the '['; the end of the class, or null if it isn't closed
+static const char *matchClass(const char *pos, const char *end, char ch, bool *matched)
+{
+    bool negate = pos < end && (*pos == '!' || *pos == '^');
+
+    if (negate)
+        ++pos;
+
+    *matched = false;
+
+    for (bool first = true; pos < end; first = false) {
+        if (*pos == ']' && !first)
+            break;
+
+        char low = *pos;
+        char high = low;
+
+        if (pos + 2 < end && pos[1] == '-' && pos[2] != ']') {
+            high = pos[2];
+            pos += 3;
+        } else {
+            ++pos;
+        }
+
+        if (ch >= low && ch <= high)
+            *matched = true;
+    }
+
+    if (pos >= end)
+        return Q_NULLPTR;
+
+    if (negate)
+        *matched = !*matched;
+
+    return pos + 1;
+}
+
+FileNameMatcher::FileNameMatcher(const QString &keyword)
+{
+    const QByteArray &utf8 = keyword.toUtf8();
+
+    m_keyword.resize(utf8.size());
+    m_pinyin = !utf8.isEmpty();
+
+    for (int i = 0; i < utf8.size(); ++i) {
+        const char ch = foldCase(utf8.at(i));
+
+        m_keyword[i] = ch;
+
+        if (ch == '*' || ch == '?')
+            m_glob = true;
+
+        if (!((ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9')))
+            m_pinyin = false;
+    }
+
+    if (m_pinyin)
+        m_pinyinKeyword = QString::fromLatin1(m_keyword);
+}
+
+bool FileNameMatcher::isGlob() const
+{
+    return m_glob;
+}
+
+bool FileNameMatcher::match(const char *name, int length) const
+{
+    if (m_keyword.isEmpty())
+        return true;
+
+    if (m_glob)
+        return matchGlob(name, name + length);
+
+    if (ContentSearchEngine::find(name, name + length, m_keyword))
+        return true;
+
+    if (!m_pinyin)
+        return false;
+
+    /// only names with non-ASCII characters can have a pinyin
+    for (int i = 0; i < length; ++i) {
+        if (uchar(name[i]) & 0x80)
+            return matchPinyin(name, length);
+    }
+
+    return false;
+}
+
+bool FileNameMatcher::match(const QString &name) const
+{
+    const QByteArray &utf8 = name.toUtf8();
+
+    return match(utf8.constData(), utf8.size());
+}
+
+/// a mismatch retries from the last '*', one character further into the name
+bool FileNameMatcher::matchGlob(const char *name, const char *nameEnd) const
+{
+    const char *pattern = m_keyword.constData();
+    const char *patternEnd = pattern + m_keyword.size();
+    const char *starPattern = Q_NULLPTR;
+    const char *starName = Q_NULLPTR;
+
+    while (name < nameEnd) {
+        if (pattern < patternEnd) {
+            const char ch = *pattern;
+
+            if (ch == '*') {
+                starPattern = ++pattern;
+                starName = name;
+
+                continue;
+            }
+
+            if (ch == '?') {
+                ++pattern;
+                name = nextChar(name, nameEnd);
+
+                continue;
+            }
+
+            if (ch == '[') {
+                bool matched;
+                const char *classEnd = matchClass(pattern + 1, patternEnd, foldCase(*name), &matched);
+
+                if (classEnd && matched) {
+                    pattern = classEnd;
+                    name = nextChar(name, nameEnd);
+
+                    continue;
+                }
+
+                /// an open '[' is an ordinary character
+                if (!classEnd && foldCase(*name) == ch) {
+                    ++pattern;
+                    ++name;
+
+                    continue;
+                }
+            } else if (foldCase(*name) == ch) {
+                ++pattern;
+                ++name;
+
+                continue;
+            }
+        }
+
+        if (!starPattern)
+            return false;
+
+        pattern = starPattern;
+        starName = nextChar(starName, nameEnd);
+        name = starName;
+    }
+
+    while (pattern < patternEnd && *pattern == '*')
+        ++pattern;
+
+    return pattern == patternEnd;
+}
+
+/// the whole pinyin without tones and the initials, non-Chinese characters
+/// are kept as they are in both
+bool FileNameMatcher::matchPinyin(const char *name, int length) const
+{
+    const QString &text = QString::fromUtf8(name, length);
+    QVarLengthArray<QChar, 16> buffer(Pinyin::MaxPinyinLength(1));
+    QString fullPinyin;
+    QString initials;
+    bool hasPinyin = false;
+
+    fullPinyin.reserve(text.size() * 4);
+    initials.reserve(text.size());
+
+    for (const QChar &ch : text) {
+        const int size = qMin(Pinyin::Chinese2Pinyin(&ch, 1, buffer.data(), buffer.size()), buffer.size());
+
+        if (size == 1 && buffer.at(0) == ch) {
+            fullPinyin += ch.toLower();
+            initials += ch.toLower();
+
+            continue;
+        }
+
+        bool first = true;
+
+        hasPinyin = true;
+
+        for (int i = 0; i < size; ++i) {
+            if (!buffer.at(i).isLetter())
+                continue;
+
+            fullPinyin += buffer.at(i);
+
+            if (first) {
+                initials += buffer.at(i);
+                first = false;
+            }
+        }
+    }
+
+    return hasPinyin && (fullPinyin.contains(m_pinyinKeyword) || initials.contains(m_pinyinKeyword));
+}
@@ -0,0 +1,34 @@
+#ifndef FILENAMEMATCHER_H
+#define FILENAMEMATCHER_H
+
+#include <QByteArray>
+#include <QString>
+
+/// Matches file names against a search keyword, compiled once per search.
+/// Names are taken as the raw UTF-8 bytes of a dirent. A keyword with * or ?
+/// is a glob that has to match the whole name, [...] classes work inside it.
+/// Any other keyword, brackets included, is a substring that ignores the case
+/// of ASCII letters. A keyword of ASCII letters and digits also finds Chinese
+/// names by their pinyin or by the initials of it, e.g. "wj" and "wenjian"
+/// both find "文件".
+class FileNameMatcher
+{
+public:
+    explicit FileNameMatcher(const QString &keyword);
+
+    bool isGlob() const;
+
+    bool match(const char *name, int length) const;
+    bool match(const QString &name) const;
+
+private:
+    bool matchGlob(const char *name, const char *nameEnd) const;
+    bool matchPinyin(const char *name, int length) const;
+
+    QByteArray m_keyword;
+    bool m_glob = false;
+    bool m_pinyin = false;
+    QString m_pinyinKeyword;
+};
+
+#endif // FILENAMEMATCHER_H
@@ -1,9 +1,8 @@
 #include "filessizeworker.h"
-#include <QFileInfo>
-#include <QDir>
-#include <QDirIterator>
 #include <QDebug>
 
+#define SIZE_UPDATE_INTERVAL 100
+
 
 FilesSizeWorker::FilesSizeWorker(const DUrlList &urls, QObject *parent) :
 
@@ -19,52 +18,28 @@ FilesSizeWorker::~FilesSizeWorker()
 
 void FilesSizeWorker::coumpueteSize()
 {
-    foreach (DUrl url, m_urls) {
-        if (stopped()){
-            return;
-        }
-        QString filePath = url.toLocalFile();
-        QFileInfo targetInfo(filePath);
-        if (targetInfo.exists()){
-            if (targetInfo.isDir()){
-                QDir d(filePath);
-                QFileInfoList entryInfoList = d.entryInfoList(QDir::AllEntries | QDir::System
-                            | QDir::NoDotAndDotDot | QDir::NoSymLinks
-                            | QDir::Hidden);
-                foreach (QFileInfo file, entryInfoList) {
-                    if (file.isFile()){
-                        if (stopped()){
-                            return;
-                        }
-                        m_size += file.size();
-                        updateSize();
-                    }
-                    else {
-                        if (stopped()){
-                            return;
-                        }
-                        QDirIterator it(file.absoluteFilePath(), QDir::AllEntries | QDir::System
-                                      | QDir::NoDotAndDotDot | QDir::NoSymLinks
-                                      | QDir::Hidden, QDirIterator::Subdirectories);
-                        while (it.hasNext()) {
-                            if (stopped()){
-                                return;
-                            }
-                            it.next();
-                            m_size += it.fileInfo().size();
-                            updateSize();
-                        }
-                    }
-                }
-            }else{
-                if (stopped()){
-                    return;
-                }
-                m_size += targetInfo.size();
-            }
-        }
-        emit sizeUpdated(m_size);
+    DirSizeEngine engine;
+
+    foreach (const DUrl &url, m_urls) {
+        if (stopped())
+            break;
+
+        engine.start(url.toLocalFile());
+    }
+
+    /// report progress at a fixed rate instead of once per file, so the receiving
+    /// dialog is not flooded with queued events while the pool is walking
+    while (!engine.waitForFinished(SIZE_UPDATE_INTERVAL)) {
+        if (stopped())
+            engine.stop();
+
+        setResult(engine.result());
     }
+
+    setResult(engine.result());
+    updateSize();
+
+    emit finished();
 }
 
 void FilesSizeWorker::updateSize()
@@ -77,11 +52,22 @@ void FilesSizeWorker::stop()
     setStopped(true);
     setSize(0);
 }
+
 qint64 FilesSizeWorker::size() const
 {
     return m_size;
 }
 
+qint64 FilesSizeWorker::diskSize() const
+{
+    return m_diskSize;
+}
+
+qint64 FilesSizeWorker::fileCount() const
+{
+    return m_fileCount;
+}
+
 void FilesSizeWorker::setSize(const qint64 &size)
 {
     m_size = size;
@@ -89,12 +75,24 @@ void FilesSizeWorker::setSize(const qint64 &size)
 
 bool FilesSizeWorker::stopped() const
 {
-    return m_stopped;
+    return m_stopped.loadAcquire();
 }
 
 void FilesSizeWorker::setStopped(bool stopped)
 {
-    m_stopped = stopped;
+    m_stopped.storeRelease(stopped);
+}
+
+void FilesSizeWorker::setResult(const DirSizeEngine::Result &result)
+{
+    bool changed = m_size != result.size;
+
+    m_size = result.size;
+    m_diskSize = result.diskSize;
+    m_fileCount = result.fileCount;
+
+    if (changed)
+        updateSize();
 }
 
 DUrlList FilesSizeWorker::urls() const
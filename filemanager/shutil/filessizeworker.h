@@ -2,7 +2,9 @@
 #define FILESSIZEWORKER_H
 
 #include <QObject>
+#include <QAtomicInt>
 #include "../models/durl.h"
+#include "dirsizeengine.h"
 
 class FilesSizeWorker : public QObject
 {
@@ -20,8 +22,12 @@ public:
     qint64 size() const;
     void setSize(const qint64 &size);
 
+    qint64 diskSize() const;
+    qint64 fileCount() const;
+
 signals:
     void sizeUpdated(qint64 size);
+    void finished();
 
 public slots:
     void coumpueteSize();
@@ -29,9 +35,13 @@ public slots:
     void stop();
 
 private:
+    void setResult(const DirSizeEngine::Result &result);
+
     DUrlList m_urls = {};
     qint64 m_size = 0;
-    bool m_stopped = false;
+    qint64 m_diskSize = 0;
+    qint64 m_fileCount = 0;
+    QAtomicInt m_stopped;
 
 };
 
@@ -4,6 +4,8 @@
 #include "thumbnailmanager.h"
 
 #include "../app/global.h"
+#include "../app/tracer.h"
+#include "../app/metrics.h"
 
 #include "../controllers/pathmanager.h"
 #include "../controllers/appcontroller.h"
@@ -28,6 +30,8 @@
 #include <QDir>
 #include <QDebug>
 #include <QImageReader>
+#include <QTimer>
+#include <QElapsedTimer>
 
 #undef signals
 extern "C" {
@@ -36,20 +40,27 @@ extern "C" {
 }
 #define signals public
 
+#define ICON_PIXMAP_CACHE_MAX_COST (64 * 1024)
+#define ICON_PREWARM_TIME_SLICE 8
 
 static GtkIconTheme* them = NULL;
 
 IconProvider::IconProvider(QObject *parent) : QObject(parent)
+  , m_pixmaps(ICON_PIXMAP_CACHE_MAX_COST)
+  , m_prewarmTimer(new QTimer(this))
+  , m_pixmapHits(Metrics::instance()->counter("iconprovider_pixmap_hits_total", "Icon pixmaps served from the cache"))
+  , m_pixmapMisses(Metrics::instance()->counter("iconprovider_pixmap_misses_total", "Icon pixmaps rasterized on demand"))
 {
+    m_prewarmTimer->setSingleShot(true);
+    m_prewarmTimer->setInterval(0);
+
+    connect(m_prewarmTimer, &QTimer::timeout, this, &IconProvider::prewarmIconPixmaps);
+
     m_gsettings = new QGSettings("com.deepin.dde.appearance",
                                  "/com/deepin/dde/appearance/");
     m_mimeDatabase = new QMimeDatabase;
     m_iconSizes << QSize(48, 48) << QSize(64, 64) << QSize(96, 96) << QSize(128, 128) << QSize(256, 256);
 
-    for (const QByteArray &mime : QImageReader::supportedMimeTypes()) {
-        m_supportImageMimeTypesSet << mime;
-    }
-
     initConnect();
     setCurrentTheme();
 
@@ -267,6 +278,87 @@ QMap<QString, QString> IconProvider::getDesktopIconPaths()
 }
 
 
+QPixmap IconProvider::iconPixmap(const QIcon &icon, const QSize &size, int devicePixelRatio, QIcon::Mode mode)
+{
+    if (icon.isNull() || size.isEmpty())
+        return QPixmap();
+
+    const PixmapKey key{icon.cacheKey(), size, devicePixelRatio, mode};
+
+    if (const QPixmap *pixmap = m_pixmaps.object(key)) {
+        m_pixmapHits->increment();
+
+        return *pixmap;
+    }
+
+    m_pixmapMisses->increment();
+
+    const QPixmap &pixmap = rasterize(icon, key);
+
+    /// zooming steps through m_iconSizes, have the next step either way ready
+    /// by then. Thumbnails and other icons of a single file aren't worth it.
+    const int sizeIndex = m_iconSizes.indexOf(size);
+
+    if (sizeIndex >= 0 && m_mimeIconKeys.contains(key.iconKey)) {
+        if (sizeIndex > 0)
+            m_prewarmQueue.append({icon, m_iconSizes.at(sizeIndex - 1), devicePixelRatio, mode});
+
+        if (sizeIndex < m_iconSizes.count() - 1)
+            m_prewarmQueue.append({icon, m_iconSizes.at(sizeIndex + 1), devicePixelRatio, mode});
+
+        m_prewarmTimer->start();
+    }
+
+    return pixmap;
+}
+
+void IconProvider::clearIconPixmaps()
+{
+    m_pixmaps.clear();
+    m_prewarmQueue.clear();
+}
+
+quint64 IconProvider::iconPixmapHits() const
+{
+    return m_pixmapHits->value();
+}
+
+quint64 IconProvider::iconPixmapMisses() const
+{
+    return m_pixmapMisses->value();
+}
+
+void IconProvider::prewarmIconPixmaps()
+{
+    QElapsedTimer timer;
+
+    timer.start();
+
+    /// rasterize in short slices so that input events are not held back
+    while (!m_prewarmQueue.isEmpty() && timer.elapsed() < ICON_PREWARM_TIME_SLICE) {
+        const PrewarmRequest &request = m_prewarmQueue.takeFirst();
+        const PixmapKey key{request.icon.cacheKey(), request.size, request.devicePixelRatio, request.mode};
+
+        if (!m_pixmaps.contains(key))
+            rasterize(request.icon, key);
+    }
+
+    if (!m_prewarmQueue.isEmpty())
+        m_prewarmTimer->start();
+}
+
+QPixmap IconProvider::rasterize(const QIcon &icon, const PixmapKey &key)
+{
+    QPixmap pixmap = icon.pixmap(key.size * key.devicePixelRatio, QIcon::Mode(key.mode));
+
+    pixmap.setDevicePixelRatio(key.devicePixelRatio);
+
+    m_pixmaps.insert(key, new QPixmap(pixmap),
+                     qMax(pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024, 1));
+
+    return pixmap;
+}
+
 void IconProvider::setTheme(const QString &themeName)
 {
     QIcon::setThemeName(themeName);
@@ -289,6 +381,8 @@ void IconProvider::handleThemeChanged(const QString &key)
         qDebug() << "Theme change from" << QIcon::themeName() << "to" << theme;
         setTheme(theme);
         m_mimeIcons.clear();
+        m_mimeIconKeys.clear();
+        clearIconPixmaps();
         emit themeChanged(theme);
     }
 }
@@ -349,13 +443,31 @@ void IconProvider::setDesktopIconPaths(const QMap<QString, QString> &iconPaths)
     m_desktopIconPaths = iconPaths;
 }
 
+bool IconProvider::isSupportImageMimeType(const QString &mimeType) const
+{
+    if (!mimeType.startsWith("image/"))
+        return false;
+
+    /// asking QImageReader loads every image plugin, a first window
+    /// without images shouldn't pay for that
+    if (m_supportImageMimeTypesSet.isEmpty()) {
+        for (const QByteArray &mime : QImageReader::supportedMimeTypes()) {
+            m_supportImageMimeTypesSet << mime;
+        }
+    }
+
+    return m_supportImageMimeTypesSet.contains(mimeType);
+}
+
 QIcon IconProvider::findIcon(const QString &absoluteFilePath, const QString &mimeType)
 {
+    TRACE_SCOPE("IconProvider::findIcon");
+
 //    qDebug() << absoluteFilePath << m_mimeDatabase->mimeTypeForFile(absoluteFilePath).iconName() << FileUtils::getFileMimetype(absoluteFilePath) << getMimeTypeByFile(absoluteFilePath) << mimeType << getFileIcon(absoluteFilePath, 256);
     QIcon theIcon;
     QString _mimeType = mimeType;
 
-    if (m_supportImageMimeTypesSet.contains(mimeType)) {
+    if (isSupportImageMimeType(mimeType)) {
         theIcon = thumbnailManager->getThumbnailIcon(absoluteFilePath);
 
         if (theIcon.isNull())
@@ -409,6 +521,7 @@ QIcon IconProvider::findIcon(const QString &absoluteFilePath, const QString &mim
     }
 
     m_mimeIcons.insert(_mimeType, theIcon);
+    m_mimeIconKeys.insert(theIcon.cacheKey());
 
     return theIcon;
 }
@@ -9,6 +9,13 @@
 #include <QFileIconProvider>
 #include <QGSettings>
 #include <QMimeDatabase>
+#include <QPixmap>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+class MetricCounter;
 
 class IconProvider : public QObject
 {
@@ -31,6 +38,13 @@ public:
     QMap<QString,QIcon> getDesktopIcons();
     QMap<QString,QString> getDesktopIconPaths();
 
+    QPixmap iconPixmap(const QIcon &icon, const QSize &size, int devicePixelRatio = 1,
+                       QIcon::Mode mode = QIcon::Normal);
+    void clearIconPixmaps();
+
+    quint64 iconPixmapHits() const;
+    quint64 iconPixmapMisses() const;
+
 signals:
     void themeChanged(const QString& theme);
     void iconChanged(const QString &filePath);
@@ -46,10 +60,44 @@ public slots:
 
     void setDesktopIconPaths(const QMap<QString,QString>& iconPaths);
 
+private slots:
+    void prewarmIconPixmaps();
+
 private:
+    bool isSupportImageMimeType(const QString &mimeType) const;
     QIcon findIcon(const QString& absoluteFilePath, const QString &mimeType);
     QString getMimeTypeByFile(const QString &file);
 
+    struct PixmapKey
+    {
+        qint64 iconKey;
+        QSize size;
+        int devicePixelRatio;
+        int mode;
+
+        inline bool operator ==(const PixmapKey &other) const
+        {
+            return iconKey == other.iconKey && size == other.size
+                    && devicePixelRatio == other.devicePixelRatio && mode == other.mode;
+        }
+
+        friend inline uint qHash(const PixmapKey &key, uint seed = 0)
+        {
+            return qHash(key.iconKey, seed) ^ qHash(key.size.width() << 16 | key.size.height())
+                    ^ qHash(key.devicePixelRatio << 4 | key.mode);
+        }
+    };
+
+    struct PrewarmRequest
+    {
+        QIcon icon;
+        QSize size;
+        int devicePixelRatio;
+        QIcon::Mode mode;
+    };
+
+    QPixmap rasterize(const QIcon &icon, const PixmapKey &key);
+
 private:
     mutable QHash<QString,QIcon> m_mimeIcons;
     mutable QMap<QString,QIcon> m_desktopIcons;
@@ -57,8 +105,17 @@ private:
     mutable QCache<QString,QIcon> m_icons;
     mutable QMap<QString,QIcon> m_thumbnailIcons;
 
-    QSet<QString> m_supportImageMimeTypesSet;
+    mutable QSet<QString> m_supportImageMimeTypesSet;
     QList<QSize> m_iconSizes;
+
+    /// shared by all views, the cost is in KiB
+    QCache<PixmapKey, QPixmap> m_pixmaps;
+    QList<PrewarmRequest> m_prewarmQueue;
+    /// the icons of m_mimeIcons, only these are shared enough to be prewarmed
+    QSet<qint64> m_mimeIconKeys;
+    QTimer *m_prewarmTimer;
+    MetricCounter *m_pixmapHits;
+    MetricCounter *m_pixmapMisses;
     QGSettings* m_gsettings;
     QMimeDatabase* m_mimeDatabase;
 };
@@ -0,0 +1,261 @@
+#include "pathcompletionengine.h"
+
+#include <QFileSystemWatcher>
+#include <QFile>
+#include <QVector>
+#include <QPair>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#define PATH_COMPLETION_CACHE_MAX_COUNT 64
+
+#define MATCH_SCORE 16
+#define CASE_BONUS 1
+#define START_BONUS 12
+#define BOUNDARY_BONUS 8
+#define CONSECUTIVE_BONUS 6
+#define GAP_PENALTY 1
+#define PREFIX_BONUS 32
+
+static int listingId = 0;
+
+static void listDirectories(PathCompletionEngine *engine, const QString &dirPath, int id,
+                            QSharedPointer<QAtomicInt> canceled)
+{
+    QStringList names;
+    bool ok = false;
+
+    if (DIR *dir = ::opendir(QFile::encodeName(dirPath).constData())) {
+        ok = true;
+
+        while (struct dirent *entry = ::readdir(dir)) {
+            if (canceled->loadAcquire()) {
+                ok = false;
+                break;
+            }
+
+            const char *name = entry->d_name;
+
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+
+            /// only links and file systems without d_type need a stat, this
+            /// is what keeps a listing on NFS from stating every entry
+            bool isDir = entry->d_type == DT_DIR;
+
+            if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN) {
+                struct stat st;
+
+                isDir = ::fstatat(::dirfd(dir), name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+            }
+
+            if (isDir)
+                names << QFile::decodeName(name);
+        }
+
+        ::closedir(dir);
+    }
+
+    if (ok)
+        names.sort();
+
+    QMetaObject::invokeMethod(engine, "onListingFinished", Qt::QueuedConnection,
+                              Q_ARG(QString, dirPath), Q_ARG(QStringList, names),
+                              Q_ARG(int, id), Q_ARG(bool, ok));
+}
+
+PathCompletionEngine::PathCompletionEngine(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+{
+    m_pool.setMaxThreadCount(2);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &PathCompletionEngine::onDirectoryChanged);
+}
+
+PathCompletionEngine::~PathCompletionEngine()
+{
+    for (const Listing &listing : m_listings) {
+        listing.canceled->storeRelease(1);
+    }
+
+    m_pool.waitForDone();
+}
+
+bool PathCompletionEngine::cachedEntries(const QString &dirPath, QStringList *names)
+{
+    auto it = m_cache.constFind(dirPath);
+
+    if (it == m_cache.constEnd())
+        return false;
+
+    *names = it.value();
+
+    m_cacheOrder.removeOne(dirPath);
+    m_cacheOrder.append(dirPath);
+
+    return true;
+}
+
+void PathCompletionEngine::requestEntries(const QString &dirPath)
+{
+    if (m_cache.contains(dirPath))
+        return;
+
+    Listing &listing = m_listings[dirPath];
+
+    ++listing.waiters;
+
+    if (listing.canceled)
+        return;
+
+    listing.canceled = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+    listing.id = ++listingId;
+
+    QtConcurrent::run(&m_pool, listDirectories, this, dirPath, listing.id, listing.canceled);
+}
+
+void PathCompletionEngine::cancelRequest(const QString &dirPath)
+{
+    auto it = m_listings.find(dirPath);
+
+    if (it == m_listings.end())
+        return;
+
+    if (--it->waiters > 0)
+        return;
+
+    it->canceled->storeRelease(1);
+    m_listings.erase(it);
+}
+
+int PathCompletionEngine::matchScore(const QString &pattern, const QString &candidate)
+{
+    if (pattern.isEmpty())
+        return 0;
+
+    if (pattern.size() > candidate.size())
+        return -1;
+
+    int score = 0;
+    int lastMatch = -1;
+    int j = 0;
+
+    /// greedy subsequence match: rewards matches at the start, after a word
+    /// boundary and in runs, penalizes the characters skipped in between
+    for (int i = 0; i < candidate.size() && j < pattern.size(); ++i) {
+        const QChar c = candidate.at(i);
+        const QChar p = pattern.at(j);
+
+        if (c != p && c.toLower() != p.toLower())
+            continue;
+
+        score += MATCH_SCORE;
+
+        if (c == p)
+            score += CASE_BONUS;
+
+        if (i == 0) {
+            score += START_BONUS;
+        } else if (lastMatch == i - 1) {
+            score += CONSECUTIVE_BONUS;
+        } else {
+            const QChar prev = candidate.at(i - 1);
+
+            if (!prev.isLetterOrNumber() || (prev.isLower() && c.isUpper()))
+                score += BOUNDARY_BONUS;
+
+            if (lastMatch >= 0)
+                score -= GAP_PENALTY * qMin(i - lastMatch - 1, 8);
+        }
+
+        lastMatch = i;
+        ++j;
+    }
+
+    if (j < pattern.size())
+        return -1;
+
+    if (candidate.startsWith(pattern, Qt::CaseInsensitive))
+        score += PREFIX_BONUS;
+
+    score -= GAP_PENALTY * qMin(candidate.size() - pattern.size(), 16);
+
+    return qMax(score, 0);
+}
+
+QStringList PathCompletionEngine::match(const QString &pattern, const QStringList &candidates, int limit)
+{
+    QVector<QPair<int, int>> matched;
+
+    for (int i = 0; i < candidates.count(); ++i) {
+        int score = matchScore(pattern, candidates.at(i));
+
+        if (score >= 0)
+            matched.append(qMakePair(score, i));
+    }
+
+    /// stable, so that candidates of the same score keep their order
+    std::stable_sort(matched.begin(), matched.end(), [] (const QPair<int, int> &a, const QPair<int, int> &b) {
+        return a.first > b.first;
+    });
+
+    QStringList list;
+
+    for (const QPair<int, int> &pair : matched) {
+        if (list.count() >= limit)
+            break;
+
+        list << candidates.at(pair.second);
+    }
+
+    return list;
+}
+
+void PathCompletionEngine::onListingFinished(const QString &dirPath, const QStringList &names, int id, bool ok)
+{
+    auto it = m_listings.find(dirPath);
+
+    /// canceled, a newer listing of the same directory may be running
+    if (it == m_listings.end() || it->id != id)
+        return;
+
+    m_listings.erase(it);
+
+    if (!ok) {
+        emit entriesFailed(dirPath);
+
+        return;
+    }
+
+    insertCache(dirPath, names);
+
+    emit entriesReady(dirPath);
+}
+
+void PathCompletionEngine::onDirectoryChanged(const QString &dirPath)
+{
+    m_watcher->removePath(dirPath);
+    m_cache.remove(dirPath);
+    m_cacheOrder.removeOne(dirPath);
+}
+
+void PathCompletionEngine::insertCache(const QString &dirPath, const QStringList &names)
+{
+    while (m_cacheOrder.count() >= PATH_COMPLETION_CACHE_MAX_COUNT) {
+        const QString &oldPath = m_cacheOrder.takeFirst();
+
+        m_watcher->removePath(oldPath);
+        m_cache.remove(oldPath);
+    }
+
+    m_cache[dirPath] = names;
+    m_cacheOrder.append(dirPath);
+    m_watcher->addPath(dirPath);
+}
@@ -0,0 +1,60 @@
+#ifndef PATHCOMPLETIONENGINE_H
+#define PATHCOMPLETIONENGINE_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QAtomicInt>
+
+QT_BEGIN_NAMESPACE
+class QFileSystemWatcher;
+QT_END_NAMESPACE
+
+class PathCompletionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PathCompletionEngine(QObject *parent = 0);
+    ~PathCompletionEngine();
+
+    bool cachedEntries(const QString &dirPath, QStringList *names);
+    void requestEntries(const QString &dirPath);
+    void cancelRequest(const QString &dirPath);
+
+    static int matchScore(const QString &pattern, const QString &candidate);
+    static QStringList match(const QString &pattern, const QStringList &candidates, int limit);
+
+signals:
+    void entriesReady(const QString &dirPath);
+    /// the directory couldn't be listed, nothing is cached for it
+    void entriesFailed(const QString &dirPath);
+
+private slots:
+    void onListingFinished(const QString &dirPath, const QStringList &names, int id, bool ok);
+    void onDirectoryChanged(const QString &dirPath);
+
+private:
+    void insertCache(const QString &dirPath, const QStringList &names);
+
+    QFileSystemWatcher *m_watcher;
+    QThreadPool m_pool;
+
+    QHash<QString, QStringList> m_cache;
+    QStringList m_cacheOrder;
+
+    /// in flight listings, keyed by directory, with the number of requests
+    /// still waiting for them. The flag is shared with the worker to stop it.
+    struct Listing
+    {
+        QSharedPointer<QAtomicInt> canceled;
+        int id = 0;
+        int waiters = 0;
+    };
+
+    QHash<QString, Listing> m_listings;
+};
+
+#endif // PATHCOMPLETIONENGINE_H
@@ -2,15 +2,21 @@
 #include "standardpath.h"
 #include "fileutils.h"
 
+#include "../app/tracer.h"
+#include "../app/metrics.h"
+
 #include <QDir>
 #include <QtConcurrent/QtConcurrentRun>
 #include <QImageReader>
 #include <QCryptographicHash>
 #include <QFileSystemWatcher>
+#include <QElapsedTimer>
 
 ThumbnailManager::ThumbnailManager(QObject *parent)
     : QThread(parent)
     , watcher(new QFileSystemWatcher(this))
+    , m_queueLength(Metrics::instance()->gauge("thumbnail_queue_length", "Files waiting for a thumbnail"))
+    , m_generateTime(Metrics::instance()->histogram("thumbnail_generate_us", "Time to scale and save a new thumbnail"))
 {
     connect(watcher, &QFileSystemWatcher::fileChanged, this, [this] (const QString &filePath) {
         const QString &md5 = m_pathToMd5.take(filePath);
@@ -67,6 +73,7 @@ void ThumbnailManager::requestThumbnailIcon(const QString &fpath)
         return;
 
     taskQueue << fpath;
+    m_queueLength->set(taskQueue.count());
 
     if (!isRunning())
         start();
@@ -75,8 +82,12 @@ void ThumbnailManager::requestThumbnailIcon(const QString &fpath)
 void ThumbnailManager::run()
 {
     while (!taskQueue.isEmpty()) {
+        TRACE_SCOPE("ThumbnailManager::run");
+
         const QString &fpath = taskQueue.dequeue();
 
+        m_queueLength->set(taskQueue.count());
+
         QFile file(fpath);
 
         /// ensure image size < 100MB
@@ -108,6 +119,9 @@ void ThumbnailManager::run()
             m_md5ToIcon[md5] = icon;
         } else {
             QImageReader reader(&file);
+            QElapsedTimer timer;
+
+            timer.start();
 
             if (reader.canRead()) {
                 QSize size = reader.size();
@@ -131,6 +145,8 @@ void ThumbnailManager::run()
                 } else {
                     QFile::link(fpath, thumbnailPath);
                 }
+
+                m_generateTime->observe(timer.nsecsElapsed() / 1000);
             }
         }
 
@@ -10,6 +10,9 @@ QT_BEGIN_NAMESPACE
 class QFileSystemWatcher;
 QT_END_NAMESPACE
 
+class MetricCounter;
+class MetricHistogram;
+
 class ThumbnailManager : public QThread
 {
     Q_OBJECT
@@ -35,6 +38,8 @@ private:
     QMap<QString, QIcon> m_md5ToIcon;
 
     QFileSystemWatcher *watcher = Q_NULLPTR;
+    MetricCounter *m_queueLength;
+    MetricHistogram *m_generateTime;
 };
 
 #endif // THUMBNAILMANAGER_H
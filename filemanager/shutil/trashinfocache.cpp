@@ -0,0 +1,370 @@
+#include "trashinfocache.h"
+#include "standardpath.h"
+
+#include "../app/global.h"
+#include "../app/metrics.h"
+
+#include <QDir>
+#include <QFile>
+#include <QDirIterator>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QDebug>
+
+#include <sys/stat.h>
+
+#define TRASHINFO_SUFFIX ".trashinfo"
+#define TRASHINFO_INDEX_MAGIC 0x54494458
+#define TRASHINFO_INDEX_VERSION 1
+
+TrashInfoCache::TrashInfoCache(QObject *parent)
+    : QObject(parent)
+    , m_indexFilePath(StandardPath::getCachePath() + "/trashinfo.index")
+    , m_hits(Metrics::instance()->counter("trashinfo_cache_hits_total", "Trash infos served from the index"))
+    , m_misses(Metrics::instance()->counter("trashinfo_cache_misses_total", "Trash infos parsed from their file"))
+{
+
+}
+
+TrashInfoCache::~TrashInfoCache()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_dirty)
+        saveIndex();
+}
+
+bool TrashInfoCache::contains(const QString &fileBaseName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    validate();
+
+    return m_infos.contains(fileBaseName);
+}
+
+bool TrashInfoCache::trashInfo(const QString &fileBaseName, TrashInfoCache::TrashInfo *info)
+{
+    QMutexLocker locker(&m_mutex);
+
+    validate();
+
+    auto it = m_infos.find(fileBaseName);
+
+    if (it == m_infos.end()) {
+        TrashInfo newInfo;
+
+        m_misses->increment();
+
+        /// the entry may have been written behind our back without touching the
+        /// directory mtime (e.g. in-place rewrite), fall back to the file itself
+        if (!loadTrashInfo(fileBaseName, &newInfo))
+            return false;
+
+        it = m_infos.insert(fileBaseName, newInfo);
+        m_dirty = true;
+    } else {
+        m_hits->increment();
+    }
+
+    if (it->size < 0) {
+        struct stat statBuffer;
+        const QByteArray &filePath = QFile::encodeName(TRASHFILEPATH + "/" + fileBaseName);
+
+        if (::lstat(filePath.constData(), &statBuffer) == 0) {
+            it->size = statBuffer.st_size;
+            m_dirty = true;
+        }
+    }
+
+    if (info)
+        *info = it.value();
+
+    return true;
+}
+
+bool TrashInfoCache::writeTrashInfo(const QString &fileBaseName, const QString &path, const QString &time)
+{
+    QMutexLocker locker(&m_mutex);
+
+    bool inSync = m_loaded && infoDirStamp() == m_stamp;
+
+    QFile metadata(TRASHINFOPATH + "/" + fileBaseName + TRASHINFO_SUFFIX);
+
+    if (!metadata.open(QIODevice::WriteOnly)) {
+        qDebug() << metadata.fileName() << "file open error:" << metadata.errorString();
+
+        return false;
+    }
+
+    QByteArray data;
+
+    data.append("[Trash Info]\n");
+    data.append("Path=").append(path.toUtf8().toPercentEncoding("/")).append("\n");
+    data.append("DeletionDate=").append(time).append("\n");
+
+    qint64 size = metadata.write(data);
+
+    metadata.close();
+
+    if (size < 0) {
+        qDebug() << "write file " << metadata.fileName() << "error:" << metadata.errorString();
+
+        return false;
+    }
+
+    TrashInfo info;
+
+    info.originalFilePath = path;
+    info.deletionDateString = time;
+    info.deletionDate = QDateTime::fromString(time, Qt::ISODate);
+
+    m_infos[fileBaseName] = info;
+    m_dirty = true;
+
+    if (inSync)
+        m_stamp = infoDirStamp();
+
+    return size > 0;
+}
+
+bool TrashInfoCache::removeTrashInfo(const QString &fileBaseName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    bool inSync = m_loaded && infoDirStamp() == m_stamp;
+    bool ok = QFile::remove(TRASHINFOPATH + "/" + fileBaseName + TRASHINFO_SUFFIX);
+
+    if (m_infos.remove(fileBaseName) > 0)
+        m_dirty = true;
+
+    if (inSync)
+        m_stamp = infoDirStamp();
+
+    return ok;
+}
+
+QString TrashInfoCache::notExistsTrashFileName(const QString &fileName)
+{
+    QByteArray name = fileName.toUtf8();
+
+    int index = name.lastIndexOf('/');
+
+    if (index >= 0)
+        name = name.mid(index + 1);
+
+    index = name.lastIndexOf('.');
+    QByteArray suffix;
+
+    if (index >= 0)
+        suffix = name.mid(index);
+
+    if (suffix.size() > 200)
+        suffix = suffix.left(200);
+
+    name.chop(suffix.size());
+    name = name.left(200 - suffix.size());
+
+    QMutexLocker locker(&m_mutex);
+
+    validate();
+
+    forever {
+        const QString &baseName = QString::fromUtf8(name + suffix);
+
+        /// the index answers the common case, the files directory may still hold
+        /// entries without metadata so the final candidate is checked on disk
+        if (!m_infos.contains(baseName) && !QFile::exists(TRASHFILEPATH + "/" + baseName))
+            return baseName;
+
+        name = QCryptographicHash::hash(name, QCryptographicHash::Md5).toHex();
+    }
+}
+
+bool TrashInfoCache::parseTrashInfo(const QByteArray &data, TrashInfoCache::TrashInfo *info)
+{
+    bool inGroup = false;
+    bool hasPath = false;
+    int begin = 0;
+
+    while (begin < data.size()) {
+        int end = data.indexOf('\n', begin);
+
+        if (end < 0)
+            end = data.size();
+
+        const char *line = data.constData() + begin;
+        int length = end - begin;
+
+        if (length > 0 && line[length - 1] == '\r')
+            --length;
+
+        begin = end + 1;
+
+        if (length <= 0)
+            continue;
+
+        if (line[0] == '[') {
+            inGroup = length == 12 && qstrncmp(line, "[Trash Info]", 12) == 0;
+
+            continue;
+        }
+
+        if (!inGroup)
+            continue;
+
+        if (length > 5 && qstrncmp(line, "Path=", 5) == 0) {
+            info->originalFilePath = QString::fromUtf8(QByteArray::fromPercentEncoding(QByteArray::fromRawData(line + 5, length - 5)));
+            hasPath = true;
+        } else if (length > 13 && qstrncmp(line, "DeletionDate=", 13) == 0) {
+            info->deletionDateString = QString::fromLatin1(line + 13, length - 13);
+            info->deletionDate = QDateTime::fromString(info->deletionDateString, Qt::ISODate);
+        }
+    }
+
+    return hasPath;
+}
+
+TrashInfoCache::DirStamp TrashInfoCache::infoDirStamp()
+{
+    DirStamp stamp;
+    struct stat statBuffer;
+
+    if (::stat(QFile::encodeName(TRASHINFOPATH).constData(), &statBuffer) == 0) {
+        stamp.sec = statBuffer.st_mtim.tv_sec;
+        stamp.nsec = statBuffer.st_mtim.tv_nsec;
+    }
+
+    return stamp;
+}
+
+void TrashInfoCache::validate()
+{
+    const DirStamp &stamp = infoDirStamp();
+
+    if (m_loaded && stamp == m_stamp)
+        return;
+
+    if (!m_loaded && loadIndex(stamp)) {
+        m_loaded = true;
+
+        return;
+    }
+
+    reload(stamp);
+}
+
+void TrashInfoCache::reload(const DirStamp &stamp)
+{
+    m_infos.clear();
+
+    QDirIterator iterator(TRASHINFOPATH, QStringList() << "*" TRASHINFO_SUFFIX,
+                          QDir::Files | QDir::Hidden | QDir::System);
+
+    while (iterator.hasNext()) {
+        iterator.next();
+
+        QString fileBaseName = iterator.fileName();
+        TrashInfo info;
+
+        fileBaseName.chop(qstrlen(TRASHINFO_SUFFIX));
+
+        if (loadTrashInfo(fileBaseName, &info))
+            m_infos.insert(fileBaseName, info);
+    }
+
+    m_stamp = stamp;
+    m_loaded = true;
+
+    saveIndex();
+}
+
+bool TrashInfoCache::loadTrashInfo(const QString &fileBaseName, TrashInfoCache::TrashInfo *info) const
+{
+    QFile file(TRASHINFOPATH + "/" + fileBaseName + TRASHINFO_SUFFIX);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    return parseTrashInfo(file.readAll(), info);
+}
+
+bool TrashInfoCache::loadIndex(const DirStamp &stamp)
+{
+    QFile file(m_indexFilePath);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    DirStamp indexStamp;
+    quint32 count = 0;
+
+    stream >> magic >> version;
+
+    if (magic != TRASHINFO_INDEX_MAGIC || version != TRASHINFO_INDEX_VERSION)
+        return false;
+
+    stream >> indexStamp.sec >> indexStamp.nsec >> count;
+
+    if (indexStamp != stamp || stream.status() != QDataStream::Ok)
+        return false;
+
+    QHash<QString, TrashInfo> infos;
+
+    infos.reserve(count);
+
+    for (quint32 i = 0; i < count; ++i) {
+        QString fileBaseName;
+        TrashInfo info;
+        qint64 deletionMSecs = -1;
+
+        stream >> fileBaseName >> info.originalFilePath >> info.deletionDateString >> deletionMSecs >> info.size;
+
+        if (stream.status() != QDataStream::Ok)
+            return false;
+
+        if (deletionMSecs >= 0)
+            info.deletionDate = QDateTime::fromMSecsSinceEpoch(deletionMSecs);
+        infos.insert(fileBaseName, info);
+    }
+
+    m_infos.swap(infos);
+    m_stamp = stamp;
+
+    return true;
+}
+
+void TrashInfoCache::saveIndex()
+{
+    QFile file(m_indexFilePath + ".tmp");
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << file.fileName() << "file open error:" << file.errorString();
+
+        return;
+    }
+
+    QDataStream stream(&file);
+
+    stream << quint32(TRASHINFO_INDEX_MAGIC) << quint32(TRASHINFO_INDEX_VERSION)
+           << m_stamp.sec << m_stamp.nsec << quint32(m_infos.count());
+
+    for (auto it = m_infos.constBegin(); it != m_infos.constEnd(); ++it) {
+        qint64 deletionMSecs = it->deletionDate.isValid() ? it->deletionDate.toMSecsSinceEpoch() : -1;
+
+        stream << it.key() << it->originalFilePath << it->deletionDateString << deletionMSecs << it->size;
+    }
+
+    file.close();
+
+    if (stream.status() != QDataStream::Ok)
+        return;
+
+    QFile::remove(m_indexFilePath);
+
+    if (file.rename(m_indexFilePath))
+        m_dirty = false;
+}
@@ -0,0 +1,67 @@
+#ifndef TRASHINFOCACHE_H
+#define TRASHINFOCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QDateTime>
+
+class MetricCounter;
+
+class TrashInfoCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct TrashInfo
+    {
+        QString originalFilePath;
+        QString deletionDateString;
+        QDateTime deletionDate;
+        qint64 size = -1;
+    };
+
+    explicit TrashInfoCache(QObject *parent = 0);
+    ~TrashInfoCache();
+
+    bool contains(const QString &fileBaseName);
+    bool trashInfo(const QString &fileBaseName, TrashInfo *info);
+
+    bool writeTrashInfo(const QString &fileBaseName, const QString &path, const QString &time);
+    bool removeTrashInfo(const QString &fileBaseName);
+
+    QString notExistsTrashFileName(const QString &fileName);
+
+    static bool parseTrashInfo(const QByteArray &data, TrashInfo *info);
+
+private:
+    struct DirStamp
+    {
+        qint64 sec = -1;
+        qint64 nsec = -1;
+
+        inline bool operator ==(const DirStamp &other) const
+        { return sec == other.sec && nsec == other.nsec; }
+        inline bool operator !=(const DirStamp &other) const
+        { return !operator ==(other); }
+    };
+
+    static DirStamp infoDirStamp();
+
+    void validate();
+    void reload(const DirStamp &stamp);
+    bool loadTrashInfo(const QString &fileBaseName, TrashInfo *info) const;
+    bool loadIndex(const DirStamp &stamp);
+    void saveIndex();
+
+    QString m_indexFilePath;
+    MetricCounter *m_hits;
+    MetricCounter *m_misses;
+    QMutex m_mutex;
+    QHash<QString, TrashInfo> m_infos;
+    DirStamp m_stamp;
+    bool m_loaded = false;
+    bool m_dirty = false;
+};
+
+#endif // TRASHINFOCACHE_H
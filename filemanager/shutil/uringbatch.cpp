@@ -0,0 +1,410 @@
+#include "uringbatch.h"
+
+#include <QDebug>
+
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#if !defined(DISABLE_IO_URING) && defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+
+/// unlinkat came with the 5.11 headers, the other operations before it
+#if defined(IORING_FEAT_NATIVE_WORKERS) && defined(__NR_io_uring_setup) && defined(STATX_TYPE)
+#define URING_BATCH_ENABLED
+#endif
+#endif
+#endif
+
+/// files per round, three submissions each for the open round
+#define URING_BATCH_FILES 64
+#define URING_BATCH_ENTRIES 256
+
+#ifdef URING_BATCH_ENABLED
+
+struct UringBatch::Queue
+{
+    int fd = -1;
+    unsigned entries = 0;
+    void *sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void *cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    void *sqeMap = MAP_FAILED;
+    size_t sqeMapSize = 0;
+
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    io_uring_sqe *sqes;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    io_uring_cqe *cqes;
+
+    /// entries put into the ring but not handed to the kernel yet
+    unsigned tail = 0;
+    unsigned queued = 0;
+
+    ~Queue()
+    {
+        if (sqeMap != MAP_FAILED)
+            ::munmap(sqeMap, sqeMapSize);
+
+        if (cqRing != MAP_FAILED && cqRing != sqRing)
+            ::munmap(cqRing, cqRingSize);
+
+        if (sqRing != MAP_FAILED)
+            ::munmap(sqRing, sqRingSize);
+
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    bool setup()
+    {
+        io_uring_params params;
+
+        memset(&params, 0, sizeof(params));
+        fd = ::syscall(__NR_io_uring_setup, URING_BATCH_ENTRIES, &params);
+
+        if (fd < 0) {
+            qDebug() << "io_uring isn't available:" << strerror(errno);
+
+            return false;
+        }
+
+        entries = params.sq_entries;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+        sqRing = ::mmap(Q_NULLPTR, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+
+        if (sqRing == MAP_FAILED)
+            return false;
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            cqRing = sqRing;
+        else
+            cqRing = ::mmap(Q_NULLPTR, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+
+        if (cqRing == MAP_FAILED)
+            return false;
+
+        sqeMapSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqeMap = ::mmap(Q_NULLPTR, sqeMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+        if (sqeMap == MAP_FAILED)
+            return false;
+
+        char *sq = static_cast<char*>(sqRing);
+        char *cq = static_cast<char*>(cqRing);
+
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqes = static_cast<io_uring_sqe*>(sqeMap);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        tail = *sqTail;
+
+        return supportsOperations();
+    }
+
+    bool supportsOperations()
+    {
+        const int opCount = 256;
+        const size_t probeSize = sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op);
+        io_uring_probe *probe = static_cast<io_uring_probe*>(::calloc(1, probeSize));
+
+        if (!probe)
+            return false;
+
+        bool supported = ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, opCount) == 0;
+
+        for (int op : {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE,
+                       IORING_OP_CLOSE, IORING_OP_UNLINKAT}) {
+            if (!supported)
+                break;
+
+            supported = op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+        }
+
+        ::free(probe);
+
+        if (!supported)
+            qDebug() << "io_uring lacks the file operations";
+
+        return supported;
+    }
+
+    io_uring_sqe *next(quint8 opcode, quint64 userData)
+    {
+        Q_ASSERT(queued < entries);
+
+        const unsigned index = tail & *sqMask;
+        io_uring_sqe *sqe = &sqes[index];
+
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = AT_FDCWD;
+        sqe->user_data = userData;
+        sqArray[index] = index;
+        ++tail;
+        ++queued;
+
+        return sqe;
+    }
+
+    /// hands the queued entries to the kernel and waits for all of them,
+    /// \a complete gets the user data and the result of every one
+    template<typename Complete>
+    bool run(Complete complete)
+    {
+        unsigned submit = queued;
+        unsigned waiting = queued;
+
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        queued = 0;
+
+        while (waiting > 0) {
+            int ret = ::syscall(__NR_io_uring_enter, fd, submit, waiting, IORING_ENTER_GETEVENTS, Q_NULLPTR, 0);
+
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                qWarning() << "io_uring_enter failed:" << strerror(errno);
+
+                return false;
+            }
+
+            submit -= qMin(submit, unsigned(ret));
+
+            unsigned head = *cqHead;
+            const unsigned cqTailValue = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+
+            for (; head != cqTailValue && waiting > 0; ++head, --waiting) {
+                const io_uring_cqe &cqe = cqes[head & *cqMask];
+
+                complete(cqe.user_data, cqe.res);
+            }
+
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+
+        return true;
+    }
+};
+
+#else
+
+struct UringBatch::Queue
+{
+    bool setup()
+    {
+        return false;
+    }
+};
+
+#endif
+
+UringBatch::UringBatch()
+    : m_queue(new Queue)
+{
+    if (!m_queue->setup()) {
+        delete m_queue;
+        m_queue = Q_NULLPTR;
+    }
+}
+
+UringBatch::~UringBatch()
+{
+    delete m_queue;
+}
+
+bool UringBatch::isValid() const
+{
+    return m_queue;
+}
+
+void UringBatch::copyFiles(QVector<UringBatch::CopyItem> &items)
+{
+    if (!m_queue)
+        return;
+
+    if (m_buffer.isEmpty())
+        m_buffer.resize(URING_BATCH_FILES * URING_BATCH_MAX_FILE_SIZE);
+
+    for (int i = 0; i < items.count() && m_queue; i += URING_BATCH_FILES) {
+        copyChunk(items.data() + i, qMin(URING_BATCH_FILES, items.count() - i));
+    }
+}
+
+QVector<bool> UringBatch::removeFiles(const QVector<QByteArray> &filePaths, int flags)
+{
+    QVector<bool> removed(filePaths.count(), false);
+
+#ifdef URING_BATCH_ENABLED
+    for (int i = 0; i < filePaths.count() && m_queue; i += URING_BATCH_ENTRIES) {
+        const int count = qMin(URING_BATCH_ENTRIES, filePaths.count() - i);
+
+        for (int j = i; j < i + count; ++j) {
+            io_uring_sqe *sqe = m_queue->next(IORING_OP_UNLINKAT, j);
+
+            sqe->addr = quintptr(filePaths.at(j).constData());
+            sqe->unlink_flags = flags;
+        }
+
+        bool ok = m_queue->run([&removed] (quint64 index, int result) {
+            removed[index] = result == 0;
+        });
+
+        if (!ok) {
+            delete m_queue;
+            m_queue = Q_NULLPTR;
+        }
+    }
+#else
+    Q_UNUSED(flags)
+#endif
+
+    return removed;
+}
+
+/// a round opens both sides and sizes the source, the next one reads and
+/// writes with the read linked to the write, the last one closes
+void UringBatch::copyChunk(UringBatch::CopyItem *items, int count)
+{
+#ifdef URING_BATCH_ENABLED
+    QVector<struct statx> stats(count);
+    QVector<int> statResults(count, -1);
+    QVector<int> sourceFds(count, -1);
+    QVector<int> targetFds(count, -1);
+    QVector<int> writeResults(count, -1);
+
+    for (int i = 0; i < count; ++i) {
+        io_uring_sqe *sqe = m_queue->next(IORING_OP_STATX, i * 3);
+
+        sqe->addr = quintptr(items[i].sourcePath.constData());
+        sqe->len = STATX_TYPE | STATX_SIZE;
+        sqe->off = quintptr(stats.data() + i);
+
+        sqe = m_queue->next(IORING_OP_OPENAT, i * 3 + 1);
+        sqe->addr = quintptr(items[i].sourcePath.constData());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+
+        sqe = m_queue->next(IORING_OP_OPENAT, i * 3 + 2);
+        sqe->addr = quintptr(items[i].targetPath.constData());
+        sqe->open_flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+        sqe->len = 0666;
+    }
+
+    bool ok = m_queue->run([&] (quint64 userData, int result) {
+        const int index = userData / 3;
+
+        switch (userData % 3) {
+        case 0:
+            statResults[index] = result;
+            break;
+        case 1:
+            sourceFds[index] = result;
+            break;
+        default:
+            targetFds[index] = result;
+            break;
+        }
+    });
+
+    if (ok) {
+        for (int i = 0; i < count; ++i) {
+            const struct statx &st = stats.at(i);
+
+            if (statResults.at(i) != 0 || sourceFds.at(i) < 0 || targetFds.at(i) < 0
+                    || !S_ISREG(st.stx_mode) || st.stx_size > URING_BATCH_MAX_FILE_SIZE)
+                continue;
+
+            items[i].size = st.stx_size;
+
+            if (st.stx_size == 0) {
+                writeResults[i] = 0;
+
+                continue;
+            }
+
+            char *buffer = m_buffer.data() + i * URING_BATCH_MAX_FILE_SIZE;
+            io_uring_sqe *sqe = m_queue->next(IORING_OP_READ, i * 2);
+
+            sqe->fd = sourceFds.at(i);
+            sqe->addr = quintptr(buffer);
+            sqe->len = st.stx_size;
+            /// a short read cancels the write
+            sqe->flags = IOSQE_IO_LINK;
+
+            sqe = m_queue->next(IORING_OP_WRITE, i * 2 + 1);
+            sqe->fd = targetFds.at(i);
+            sqe->addr = quintptr(buffer);
+            sqe->len = st.stx_size;
+        }
+
+        ok = m_queue->run([&writeResults] (quint64 userData, int result) {
+            if (userData % 2)
+                writeResults[userData / 2] = result;
+        });
+    }
+
+    for (int i = 0; i < count; ++i) {
+        items[i].done = ok && writeResults.at(i) == items[i].size;
+    }
+
+    /// fds of a broken ring are closed here, the others in one more round
+    for (int i = 0; i < count; ++i) {
+        for (int fd : {sourceFds.at(i), targetFds.at(i)}) {
+            if (fd < 0)
+                continue;
+
+            if (ok) {
+                io_uring_sqe *sqe = m_queue->next(IORING_OP_CLOSE, i * 2 + (fd == targetFds.at(i)));
+
+                sqe->fd = fd;
+            } else {
+                ::close(fd);
+            }
+        }
+    }
+
+    if (ok) {
+        ok = m_queue->run([items] (quint64 userData, int result) {
+            /// a failed close of the target can be a failed write back
+            if (userData % 2 && result < 0)
+                items[userData / 2].done = false;
+        });
+    }
+
+    if (!ok) {
+        delete m_queue;
+        m_queue = Q_NULLPTR;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (!items[i].done && targetFds.at(i) >= 0)
+            ::unlink(items[i].targetPath.constData());
+    }
+#else
+    Q_UNUSED(items)
+    Q_UNUSED(count)
+#endif
+}
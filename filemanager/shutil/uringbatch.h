@@ -0,0 +1,47 @@
+#ifndef URINGBATCH_H
+#define URINGBATCH_H
+
+#include <QByteArray>
+#include <QVector>
+
+/// the largest file copyFiles() takes, larger ones are left to the caller
+#define URING_BATCH_MAX_FILE_SIZE (64 * 1024)
+
+/// Copies and removes many small files with a few io_uring submissions
+/// instead of a handful of system calls per file. A batch of files is opened,
+/// sized with statx, read, written and closed in three rounds to the kernel.
+/// Without io_uring (an old kernel, a seccomp filter, or a build with
+/// CONFIG+=no_io_uring) isValid() is false and the callers keep their
+/// synchronous path. Items the batch couldn't do are reported back as such,
+/// nothing is left behind for them.
+class UringBatch
+{
+public:
+    struct CopyItem
+    {
+        QByteArray sourcePath;
+        /// created exclusively, an existing target leaves the item undone
+        QByteArray targetPath;
+        qint64 size = 0;
+        bool done = false;
+    };
+
+    UringBatch();
+    ~UringBatch();
+
+    bool isValid() const;
+
+    void copyFiles(QVector<CopyItem> &items);
+    /// unlinkat() for every path, \a flags as for it; whether each was removed
+    QVector<bool> removeFiles(const QVector<QByteArray> &filePaths, int flags = 0);
+
+private:
+    struct Queue;
+
+    void copyChunk(CopyItem *items, int count);
+
+    Queue *m_queue = Q_NULLPTR;
+    QByteArray m_buffer;
+};
+
+#endif // URINGBATCH_H
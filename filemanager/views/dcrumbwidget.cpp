@@ -92,12 +92,8 @@ void DCrumbWidget::addCrumb(const QStringList &list)
 
             button->setPath(path);
 
-            if (systemPathManager->systemPathsMap().values().contains(path)){
-                foreach (QString key, systemPathManager->systemPathsMap().keys()) {
-                    if (systemPathManager->systemPathsMap().value(key) == path){
-                           button->setText(systemPathManager->getSystemPathDisplayName(key));
-                    }
-                }
+            if (systemPathManager->isSystemPath(path)){
+                button->setText(systemPathManager->getSystemPathDisplayNameByPath(path));
             }
 
             button->setFocusPolicy(Qt::NoFocus);
@@ -4,14 +4,23 @@
 #include "deditorwidgetmenu.h"
 
 #include "../app/global.h"
+#include "../app/metrics.h"
+
+#include "../shutil/iconprovider.h"
+
+#include "widgets/singleton.h"
 
 #include <QLabel>
 #include <QPainter>
 #include <QTextEdit>
 #include <QLineEdit>
 #include <QTextBlock>
+#include <QStaticText>
 #include <QAbstractTextDocumentLayout>
 #include <QApplication>
+#include <QScrollBar>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
 
 #define ICON_SPACING 16
 #define ICON_MODE_RECT_RADIUS 4
@@ -20,10 +29,75 @@
 #define LIST_MODE_EDITOR_LEFT_PADDING -9
 #define SELECTED_BACKGROUND_COLOR "#2da6f7"
 #define ICON_MODE_TEXT_COLOR "#303030"
+#define TEXT_LAYOUT_CACHE_MAX_COUNT 4000
+#define TEXT_LAYOUT_PREFETCH_DELAY 50
+#define WORD_WRAP_MODE -1
+
+QString trimmedEnd(QString str);
+
+/// shared by paint and the prefetch worker, so both produce the same layout
+static QString layoutText(const QString &text, const QSize &size, const QFont &font, int mode, int *height)
+{
+    if (mode == WORD_WRAP_MODE) {
+        return trimmedEnd(Global::wordWrapText(text, size.width(),
+                                               QTextOption::WrapAtWordBoundaryOrAnywhere, height));
+    }
+
+    return trimmedEnd(Global::elideText(text, size, QFontMetrics(font),
+                                        QTextOption::WrapAtWordBoundaryOrAnywhere,
+                                        Qt::TextElideMode(mode)));
+}
+
+static void layoutTexts(QObject *delegate, const QStringList &texts, const QSize &size,
+                        const QFont &font, int devicePixelRatio, int mode)
+{
+    QStringList layoutTextList;
+
+    layoutTextList.reserve(texts.count());
+
+    for (const QString &text : texts) {
+        layoutTextList << layoutText(text, size, font, mode, Q_NULLPTR);
+    }
+
+    QMetaObject::invokeMethod(delegate, "onTextLayoutsPrefetched", Qt::QueuedConnection,
+                              Q_ARG(QStringList, texts), Q_ARG(QStringList, layoutTextList),
+                              Q_ARG(QSize, size), Q_ARG(QFont, font),
+                              Q_ARG(int, devicePixelRatio), Q_ARG(int, mode));
+}
+
+/// QIcon::paint() rasterizes again on every call, draw the shared pixmap instead
+static void paintIcon(QPainter *painter, const QIcon &icon, const QRect &rect, QIcon::Mode mode = QIcon::Normal)
+{
+    const QPixmap &pixmap = fileIconProvider->iconPixmap(icon, rect.size(), painter->device()->devicePixelRatio(), mode);
+
+    if (pixmap.isNull())
+        return;
+
+    QRect pixmapRect(QPoint(0, 0), pixmap.size() / pixmap.devicePixelRatio());
+
+    pixmapRect.moveCenter(rect.center());
+    painter->drawPixmap(pixmapRect, pixmap);
+}
+
+DFileItemDelegate::TextLayout::~TextLayout()
+{
+    delete document;
+    delete staticText;
+}
 
 DFileItemDelegate::DFileItemDelegate(DFileView *parent) :
     QStyledItemDelegate(parent)
+    , m_textLayouts(TEXT_LAYOUT_CACHE_MAX_COUNT)
+    , m_prefetchTimer(new QTimer(this))
 {
+    m_prefetchPool.setMaxThreadCount(1);
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(TEXT_LAYOUT_PREFETCH_DELAY);
+
+    connect(m_prefetchTimer, &QTimer::timeout, this, &DFileItemDelegate::prefetchTextLayouts);
+    connect(parent->verticalScrollBar(), &QScrollBar::valueChanged,
+            m_prefetchTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+
     expanded_item = new FileIconItem(parent->viewport());
     expanded_item->setAttribute(Qt::WA_TransparentForMouseEvents);
     expanded_item->setProperty("showBackground", true);
@@ -46,14 +120,15 @@ DFileItemDelegate::DFileItemDelegate(DFileView *parent) :
 
     connect(parent, &DListView::iconSizeChanged,
             this, [this] {
-        m_elideMap.clear();
-        m_wordWrapMap.clear();
-        m_textHeightMap.clear();
+        /// the old layouts can't be hit anymore, their key holds the old size
+        m_textLayouts.clear();
     });
 }
 
 DFileItemDelegate::~DFileItemDelegate()
 {
+    m_prefetchPool.waitForDone();
+
     if (expanded_item) {
         expanded_item->setParent(0);
         expanded_item->canDeferredDelete = true;
@@ -174,7 +249,7 @@ void DFileItemDelegate::updateEditorGeometry(QWidget *editor, const QStyleOption
 
             initStyleOption(&opt, index);
 
-            QPixmap pixmap = opt.icon.pixmap(icon_size, QIcon::Selected);
+            QPixmap pixmap = fileIconProvider->iconPixmap(opt.icon, icon_size, parent()->devicePixelRatio(), QIcon::Selected);
             QPainter painter(&pixmap);
 
             /// draw file additional icon
@@ -230,7 +305,7 @@ void DFileItemDelegate::setEditorData(QWidget *editor, const QModelIndex &index)
         initStyleOption(&opt, index);
 
         const QSize &icon_size = parent()->iconSize();
-        QPixmap pixmap = opt.icon.pixmap(icon_size, QIcon::Selected);
+        QPixmap pixmap = fileIconProvider->iconPixmap(opt.icon, icon_size, parent()->devicePixelRatio(), QIcon::Selected);
         QPainter painter(&pixmap);
 
         /// draw file additional icon
@@ -323,6 +398,104 @@ QString trimmedEnd(QString str)
     return str;
 }
 
+DFileItemDelegate::TextLayout *DFileItemDelegate::textLayout(const QString &text, const QSize &size, const QFont &font,
+                                                             int devicePixelRatio, int mode) const
+{
+    static MetricCounter *hits = Metrics::instance()->counter("delegate_text_layout_hits_total", "Item texts painted from a cached layout");
+    static MetricCounter *misses = Metrics::instance()->counter("delegate_text_layout_misses_total", "Item texts laid out while painting");
+
+    const TextLayoutKey key{text, size, font, devicePixelRatio, mode};
+
+    if (TextLayout *layout = m_textLayouts.object(key)) {
+        hits->increment();
+
+        return layout;
+    }
+
+    misses->increment();
+
+    TextLayout *layout = new TextLayout;
+
+    layout->text = layoutText(text, size, font, mode, &layout->height);
+    m_textLayouts.insert(key, layout);
+
+    return layout;
+}
+
+void DFileItemDelegate::prefetchTextLayouts()
+{
+    if (m_prefetchRunning || !parent()->isIconViewMode() || !parent()->model())
+        return;
+
+    const QSize &itemSize = parent()->itemSizeHint();
+    int columnCount = parent()->itemCountForRow();
+
+    if (itemSize.isEmpty() || columnCount <= 0)
+        return;
+
+    /// same geometry as the elided label of paintIconItem
+    QRect label_rect(QPoint(0, 0), itemSize);
+
+    label_rect.setTop(parent()->iconSize().height() - 1 + TEXT_PADDING + ICON_MODE_ICON_SPACING);
+    label_rect.setWidth(itemSize.width() - 2 * TEXT_PADDING);
+
+    if (label_rect.isEmpty())
+        return;
+
+    const QModelIndex &first = parent()->indexAt(QPoint(parent()->viewportMargins().left() + itemSize.width() / 2,
+                                                        itemSize.height() / 2));
+
+    if (!first.isValid())
+        return;
+
+    /// one page above and one page below the visible one
+    int pageCount = (parent()->viewport()->height() / qMax(itemSize.height(), 1) + 1) * columnCount;
+    int rowCount = parent()->model()->rowCount(parent()->rootIndex());
+    int begin = qMax(first.row() - pageCount, 0);
+    int end = qMin(first.row() + 2 * pageCount, rowCount);
+    const QFont &font = parent()->font();
+    int devicePixelRatio = parent()->devicePixelRatio();
+    Qt::TextElideMode mode = parent()->textElideMode();
+    QStringList texts;
+
+    for (int i = begin; i < end; ++i) {
+        const QString &text = parent()->model()->index(i, 0, parent()->rootIndex()).data(Qt::DisplayRole).toString();
+
+        if (!text.isEmpty() && !m_textLayouts.contains({text, label_rect.size(), font, devicePixelRatio, mode}))
+            texts << text;
+    }
+
+    if (texts.isEmpty())
+        return;
+
+    m_prefetchRunning = true;
+
+    QtConcurrent::run(&m_prefetchPool, layoutTexts, this, texts, label_rect.size(), font, devicePixelRatio, int(mode));
+}
+
+void DFileItemDelegate::onTextLayoutsPrefetched(const QStringList &texts, const QStringList &layoutTexts,
+                                                const QSize &size, const QFont &font, int devicePixelRatio, int mode)
+{
+    m_prefetchRunning = false;
+
+    for (int i = 0; i < texts.count(); ++i) {
+        const TextLayoutKey key{texts.at(i), size, font, devicePixelRatio, mode};
+
+        /// painted in the meantime, keep the layout that may hold a document
+        if (m_textLayouts.contains(key))
+            continue;
+
+        TextLayout *layout = new TextLayout;
+
+        layout->text = layoutTexts.at(i);
+        m_textLayouts.insert(key, layout);
+    }
+
+    /// the view may have scrolled on while the worker was busy, a rerun
+    /// stops at once when everything around the visible page is cached
+    m_prefetchTimer->start();
+}
+
 void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewItem &option,
                                       const QModelIndex &index, bool isDragMode, bool isActive) const
 {
@@ -373,28 +546,18 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
 
     /// if has selected show all file name else show elide file name.
     bool singleSelected = parent()->selectedIndexCount() < 2;
+    TextLayout *layout;
 
     if (isSelected && singleSelected) {
         const_cast<DFileItemDelegate*>(this)->hideExpandedIndex();
 
-        int height = 0;
-
         /// init file name text
 
-        if(m_wordWrapMap.contains(str)) {
-            str = m_wordWrapMap.value(str);
-            height = m_textHeightMap.value(str);
-        } else {
-            QString wordWrap_str = Global::wordWrapText(str, label_rect.width(),
-                                                        QTextOption::WrapAtWordBoundaryOrAnywhere,
-                                                        &height);
+        layout = textLayout(str, QSize(label_rect.width(), 0), painter->font(),
+                            painter->device()->devicePixelRatio(), WORD_WRAP_MODE);
+        str = layout->text;
 
-            wordWrap_str = trimmedEnd(wordWrap_str);
-
-            m_wordWrapMap[str] = wordWrap_str;
-            m_textHeightMap[wordWrap_str] = height;
-            str = wordWrap_str;
-        }
+        int height = layout->height;
 
         if(height > label_rect.height()) {
             /// use widget(FileIconItem) show file icon and file name label.
@@ -413,20 +576,9 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
     } else {
         /// init file name text
 
-        if(m_elideMap.contains(str)) {
-            str = m_elideMap.value(str);
-        } else {
-            QString elide_str = Global::elideText(str, label_rect.size(),
-                                                  painter->fontMetrics(),
-                                                  QTextOption::WrapAtWordBoundaryOrAnywhere,
-                                                  opt.textElideMode);
-
-            elide_str = trimmedEnd(elide_str);
-
-            m_elideMap[str] = elide_str;
-
-            str = elide_str;
-        }
+        layout = textLayout(str, label_rect.size(), painter->font(),
+                            painter->device()->devicePixelRatio(), opt.textElideMode);
+        str = layout->text;
 
         if (!singleSelected) {
             const_cast<DFileItemDelegate*>(this)->hideExpandedIndex();
@@ -437,9 +589,10 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
 
     if (isSelected) {
         painter->setPen(Qt::white);
-        opt.icon.paint(painter, icon_rect, Qt::AlignCenter, QIcon::Selected);
+        paintIcon(painter, opt.icon, icon_rect, QIcon::Selected);
     } else if (isActive) {
-        QPixmap pixmap = opt.icon.pixmap(icon_rect.size());
+        QPixmap pixmap = fileIconProvider->iconPixmap(opt.icon, icon_rect.size(),
+                                                        painter->device()->devicePixelRatio());
 
         QPainter p(&pixmap);
 
@@ -449,7 +602,7 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
 
         painter->drawPixmap(icon_rect, pixmap);
     } else {
-        opt.icon.paint(painter, icon_rect);
+        paintIcon(painter, opt.icon, icon_rect);
     }
 
     /// draw file additional icon
@@ -464,10 +617,10 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
     /// draw file name label
 
     if(str.indexOf("\n") >=0 && !str.endsWith("\n")) {
-        QTextDocument *doc = m_documentMap.value(str);
+        QTextDocument *doc = layout->document;
 
         if(!doc) {
-            doc = new QTextDocument(str, const_cast<DFileItemDelegate*>(this));
+            doc = new QTextDocument(str);
 
             QTextCursor cursor(doc);
             QTextOption text_option(Qt::AlignHCenter);
@@ -485,7 +638,7 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
                 cursor.setBlockFormat(format);
             } while (cursor.movePosition(QTextCursor::NextBlock));
 
-            m_documentMap[str] = doc;
+            layout->document = doc;
         }
 
         QAbstractTextDocumentLayout::PaintContext ctx;
@@ -514,10 +667,22 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
         doc->documentLayout()->draw(painter, ctx);
         painter->restore();
     } else {
+        QStaticText *text = layout->staticText;
+
+        if (!text) {
+            text = new QStaticText(str);
+            text->setTextFormat(Qt::PlainText);
+            text->prepare(painter->transform(), painter->font());
+
+            layout->staticText = text;
+        }
+
+        const QSize &textSize = text->size().toSize();
+        const QPoint textPos(label_rect.left() + (label_rect.width() - textSize.width()) / 2, label_rect.top());
+
         if(isSelected) {
-            QRect rect;
+            QRect rect(textPos, textSize);
 
-            painter->drawText(label_rect, Qt::AlignHCenter, str, &rect);
             rect += QMargins(TEXT_PADDING, TEXT_PADDING, TEXT_PADDING, TEXT_PADDING);
 
             QPainterPath path;
@@ -531,7 +696,7 @@ void DFileItemDelegate::paintIconItem(QPainter *painter, const QStyleOptionViewI
             painter->fillRect(label_rect, Qt::transparent);
         }
 
-        painter->drawText(label_rect, Qt::AlignHCenter, str);
+        painter->drawStaticText(textPos, *text);
     }
 }
 
@@ -596,7 +761,8 @@ void DFileItemDelegate::paintListItem(QPainter *painter, const QStyleOptionViewI
     icon_rect.moveTop(icon_rect.top() + (opt.rect.bottom() - icon_rect.bottom()) / 2);
 
     if (isActive) {
-        QPixmap pixmap = opt.icon.pixmap(icon_rect.size());
+        QPixmap pixmap = fileIconProvider->iconPixmap(opt.icon, icon_rect.size(),
+                                                        painter->device()->devicePixelRatio());
 
         QPainter p(&pixmap);
 
@@ -606,7 +772,7 @@ void DFileItemDelegate::paintListItem(QPainter *painter, const QStyleOptionViewI
 
         painter->drawPixmap(icon_rect, pixmap);
     } else {
-        opt.icon.paint(painter, icon_rect);
+        paintIcon(painter, opt.icon, icon_rect);
     }
 
     /// draw file additional icon
@@ -721,18 +887,8 @@ QList<QRect> DFileItemDelegate::paintGeomertys(const QStyleOptionViewItem &optio
 
         /// init file name text
 
-        if(m_elideMap.contains(str)) {
-            str = m_elideMap.value(str);
-        } else {
-            QString elide_str = Global::elideText(str, label_rect.size(),
-                                                  option.fontMetrics,
-                                                  QTextOption::WrapAtWordBoundaryOrAnywhere,
-                                                  option.textElideMode);
-
-            m_elideMap[str] = elide_str;
-
-            str = elide_str;
-        }
+        str = textLayout(str, label_rect.size(), option.font, parent()->devicePixelRatio(),
+                         option.textElideMode)->text;
 
         /// draw icon and file name label
 
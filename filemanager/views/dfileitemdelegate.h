@@ -5,6 +5,9 @@
 
 #include <QStyledItemDelegate>
 #include <QHeaderView>
+#include <QCache>
+#include <QFont>
+#include <QThreadPool>
 
 DWIDGET_USE_NAMESPACE
 
@@ -12,6 +15,8 @@ class FileIconItem;
 
 QT_BEGIN_NAMESPACE
 class QTextDocument;
+class QStaticText;
+class QTimer;
 QT_END_NAMESPACE
 
 class DFileItemDelegate : public QStyledItemDelegate
@@ -63,13 +68,54 @@ protected:
     void initStyleOption(QStyleOptionViewItem *option,
                          const QModelIndex &index) const Q_DECL_OVERRIDE;
 
+private slots:
+    void prefetchTextLayouts();
+    void onTextLayoutsPrefetched(const QStringList &texts, const QStringList &layoutTexts,
+                                 const QSize &size, const QFont &font, int devicePixelRatio, int mode);
+
 private:
+    struct TextLayoutKey
+    {
+        QString text;
+        QSize size;
+        QFont font;
+        int devicePixelRatio;
+        int mode;
+
+        inline bool operator ==(const TextLayoutKey &other) const
+        {
+            return text == other.text && size == other.size && devicePixelRatio == other.devicePixelRatio
+                    && mode == other.mode && font == other.font;
+        }
+
+        friend inline uint qHash(const TextLayoutKey &key, uint seed = 0)
+        {
+            return qHash(key.text, seed) ^ qHash(key.size.width()) ^ qHash(key.size.height() << 16)
+                    ^ qHash(key.font, seed) ^ qHash(key.devicePixelRatio << 8) ^ qHash(key.mode << 24);
+        }
+    };
+
+    struct TextLayout
+    {
+        QString text;
+        int height = 0;
+        /// only built when they are painted, the document for multi-line texts
+        QTextDocument *document = Q_NULLPTR;
+        /// and the static text for a single line
+        QStaticText *staticText = Q_NULLPTR;
+
+        ~TextLayout();
+    };
+
+    TextLayout *textLayout(const QString &text, const QSize &size, const QFont &font,
+                           int devicePixelRatio, int mode) const;
+
     QPointer<FileIconItem> expanded_item;
 
-    mutable QHash<QString, QString> m_elideMap;
-    mutable QHash<QString, QString> m_wordWrapMap;
-    mutable QHash<QString, int> m_textHeightMap;
-    mutable QHash<QString, QTextDocument*> m_documentMap;
+    mutable QCache<TextLayoutKey, TextLayout> m_textLayouts;
+    QTimer *m_prefetchTimer;
+    QThreadPool m_prefetchPool;
+    bool m_prefetchRunning = false;
     mutable QModelIndex expanded_index;
     mutable QModelIndex editing_index;
     mutable QModelIndex lastAndExpandedInde;
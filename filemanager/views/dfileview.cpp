@@ -26,6 +26,8 @@
 
 #include "../shutil/fileutils.h"
 #include "../shutil/iconprovider.h"
+#include "../shutil/emblemmanager.h"
+#include "../shutil/childcountmanager.h"
 #include "../shutil/mimesappsmanager.h"
 
 #include "widgets/singleton.h"
@@ -164,6 +166,29 @@ void DFileView::initConnects()
         update(model()->index(DUrl::fromLocalFile(filePath)));
     });
 
+    /// the counts of a folder arrive in batches, sort once a burst is over
+    m_childCountSortTimer = new QTimer(this);
+    m_childCountSortTimer->setSingleShot(true);
+    m_childCountSortTimer->setInterval(300);
+
+    connect(childCountManager, &ChildCountManager::childCountChanged, this, [this] (const QString &filePath) {
+        const QModelIndex &index = model()->index(DUrl::fromLocalFile(filePath));
+
+        if (!index.isValid())
+            return;
+
+        update(index);
+
+        if (model()->sortRole() == DFileSystemModel::FileSizeRole)
+            m_childCountSortTimer->start();
+    });
+    connect(m_childCountSortTimer, &QTimer::timeout, model(), static_cast<void (DFileSystemModel::*)()>(&DFileSystemModel::sort));
+#if defined(MENU_DIALOG_PLUGIN) || defined(SW_LABEL)
+    connect(emblemManager, &EmblemManager::emblemChanged, this, [this] (const QString &filePath) {
+        update(model()->index(DUrl::fromLocalFile(filePath)));
+    });
+#endif
+
     if (!m_cutUrlSet.capacity()) {
         m_cutUrlSet.reserve(1);
 
@@ -563,9 +588,20 @@ QList<QIcon> DFileView::fileAdditionalIcon(const QModelIndex &index) const
 
     if (!fileInfo)
         return icons;
+#if defined(MENU_DIALOG_PLUGIN) || defined(SW_LABEL)
+    /// plugin and label emblems are resolved in batches by emblemManager, an item
+    /// whose emblems are not cached yet is painted without them until emblemChanged
+    EmblemManager::Emblems emblems;
+
+    const QString &filePath = fileInfo->absoluteFilePath();
+    qint64 mtime = fileInfo->lastModified().toMSecsSinceEpoch();
+
+    if (!emblemManager->emblems(filePath, mtime, &emblems))
+        emblemManager->requestEmblems(filePath, mtime);
+#endif
 #ifdef MENU_DIALOG_PLUGIN
     // 调用插件，处理增加的小图标, by  txx
-    pluginManagerApp->fileAdditionalIcon( fileInfo->absoluteFilePath(), icons );
+    icons << emblems.pluginIcons;
 #endif
     if (fileInfo->isSymLink()) {
         icons << linkIcon;
@@ -578,11 +614,7 @@ QList<QIcon> DFileView::fileAdditionalIcon(const QModelIndex &index) const
         icons << unreadableIcon;
 
 #ifdef SW_LABEL
-    QString labelIconPath = fileInfo->getLabelIcon();
-    if (!labelIconPath.isEmpty()){
-        icons << QIcon(labelIconPath);
-//        qDebug() << labelIconPath;
-    }
+    icons << emblems.labelIcons;
 #endif
 
     return icons;
@@ -1620,28 +1652,23 @@ void DFileView::keyboardSearch(const QString &search)
 {
     m_keyboardSearchKeys.append(search);
     m_keyboardSearchTimer->start();
-    QModelIndexList matchModelIndexListCaseSensitive = model()->match(rootIndex(), DFileSystemModel::FilePinyinName, m_keyboardSearchKeys, -1,
-                                                                      Qt::MatchFlags(Qt::MatchStartsWith|Qt::MatchWrap | Qt::MatchCaseSensitive | Qt::MatchRecursive));
-    foreach (const QModelIndex& index, matchModelIndexListCaseSensitive) {
-        QString absolutePath = FileInfo(model()->getUrlByIndex(index).path()).absolutePath();
-        if (absolutePath == currentUrl().path()){
-            setCurrentIndex(index);
-            scrollTo(index, PositionAtTop);
-            return;
-        }
-    }
 
-    QModelIndexList matchModelIndexListNoCaseSensitive = model()->match(rootIndex(), DFileSystemModel::FilePinyinName, m_keyboardSearchKeys, -1,
-                                                                        Qt::MatchFlags(Qt::MatchStartsWith|Qt::MatchWrap | Qt::MatchRecursive));
-    foreach (const QModelIndex& index, matchModelIndexListNoCaseSensitive) {
-        QString absolutePath = FileInfo(model()->getUrlByIndex(index).path()).absolutePath();
-        if (absolutePath == currentUrl().path()){
-            setCurrentIndex(index);
-            scrollTo(index, PositionAtTop);
-            return;
-        }
+    QString keys = m_keyboardSearchKeys;
+    int startRow = currentIndex().isValid() ? currentIndex().row() : 0;
+
+    /// the same letter typed again steps to the next name starting with it
+    if (keys.count() > 1 && keys.count(keys.at(0)) == keys.count()) {
+        keys = keys.left(1);
+        ++startRow;
     }
 
+    const QModelIndex &index = model()->keyboardSearch(keys, startRow);
+
+    if (!index.isValid())
+        return;
+
+    setCurrentIndex(index);
+    scrollTo(index, PositionAtTop);
 }
 
 bool DFileView::setCurrentUrl(DUrl fileUrl)
@@ -235,6 +235,7 @@ private:
     int m_horizontalOffset = 0;
 
     QTimer* m_keyboardSearchTimer;
+    QTimer* m_childCountSortTimer;
     QString m_keyboardSearchKeys;
 
     QSize m_itemSizeHint;
@@ -5,6 +5,8 @@
 
 #include "../controllers/searchhistroymanager.h"
 
+#include "../shutil/pathcompletionengine.h"
+
 #include "../app/global.h"
 #include "../app/filesignalmanager.h"
 #include "../app/fmevent.h"
@@ -18,6 +20,8 @@
 #include <QDebug>
 #include <QApplication>
 
+#define COMPLETION_MAX_COUNT 100
+
 DSearchBar::DSearchBar(QWidget *parent):QLineEdit(parent)
 {
     initUI();
@@ -81,7 +85,7 @@ QStringList DSearchBar::splitPath(const QString &path)
 
 DSearchBar::~DSearchBar()
 {
-
+    cancelCompletion();
 }
 
 void DSearchBar::setPopup(QListWidget *popup)
@@ -144,6 +148,10 @@ void DSearchBar::initConnections()
     connect(this, &DSearchBar::textChanged, this, &DSearchBar::setCompleter);
     connect(m_list, &QListWidget::itemClicked, this, &DSearchBar::completeText);
     connect(qApp, &QApplication::focusChanged, this, &DSearchBar::handleApplicationChanged);
+    connect(pathCompletionEngine, &PathCompletionEngine::entriesReady,
+            this, &DSearchBar::onCompletionEntriesReady);
+    connect(pathCompletionEngine, &PathCompletionEngine::entriesFailed,
+            this, &DSearchBar::onCompletionEntriesFailed);
 }
 
 void DSearchBar::doTextChanged(QString text)
@@ -159,6 +167,7 @@ void DSearchBar::doTextChanged(QString text)
 void DSearchBar::searchHistoryLoaded(const QStringList &list)
 {
     m_historyList.append(list);
+    m_historySet.unite(list.toSet());
     m_stringListMode->setStringList(m_historyList);
 }
 
@@ -168,10 +177,11 @@ void DSearchBar::historySaved()
         return;
     QString str = text();
     if (!hasScheme()){
-        if(!m_historyList.contains(str))
+        if(!m_historySet.contains(str))
         {
 
             m_historyList.append(str);
+            m_historySet.insert(str);
             m_stringListMode->setStringList(m_historyList);
             searchHistoryManager->writeIntoSearchHistory(str);
         }
@@ -188,6 +198,7 @@ void DSearchBar::setCompleter(const QString &text)
 
     if (text.isEmpty())
     {
+        cancelCompletion();
         m_list->hide();
         return;
     }
@@ -198,6 +209,11 @@ void DSearchBar::setCompleter(const QString &text)
         return;
     }
 
+    showCompletion(text);
+}
+
+void DSearchBar::showCompletion(const QString &text)
+{
     m_list->clear();
 
     const DUrl &url = DUrl::fromUserInput(text);
@@ -211,24 +227,29 @@ void DSearchBar::setCompleter(const QString &text)
         }else{
             fileInfo = QFileInfo(url.path().isEmpty() ? "/" : url.toLocalFile());
         }
-//        qDebug() << url.toLocalFile() << fileInfo.absolutePath() << fileInfo.path() << QDir::cleanPath(url.toLocalFile());
-        QDir dir(fileInfo.absolutePath());
-        QStringList localList = splitPath(text);
-        QStringList sl;
-//        qDebug() << fileInfo.absolutePath();
-        foreach(QFileInfo info, dir.entryInfoList(QDir::AllDirs| QDir::Hidden |QDir::NoDotAndDotDot, QDir::Name))
-        {
-            QString temp = localList.last();
-//            qDebug() << temp << info.absoluteFilePath() << fileInfo.absoluteFilePath();
-            if (info.absoluteFilePath().mid(0, fileInfo.absoluteFilePath().length())
-                    == fileInfo.absoluteFilePath())
-            {
-                if(temp.isEmpty())
-                    sl << info.fileName();
-                else if(temp.at(0) == info.fileName().at(0))
-                    sl << info.fileName();
+
+        const QString &dirPath = QDir::cleanPath(fileInfo.absolutePath());
+        const QString &pattern = text.endsWith(".") ? QString() : splitPath(text).last();
+        QStringList entries;
+
+        /// the directory is listed off the GUI thread, the completion is shown
+        /// once entriesReady arrives, if the text has not changed meanwhile
+        if (!pathCompletionEngine->cachedEntries(dirPath, &entries)) {
+            if (m_completionDirPath != dirPath) {
+                cancelCompletion();
+                m_completionDirPath = dirPath;
+                pathCompletionEngine->requestEntries(dirPath);
             }
+
+            m_completionText = text;
+            m_list->hide();
+            return;
         }
+
+        cancelCompletion();
+
+        QStringList sl = PathCompletionEngine::match(pattern, entries, COMPLETION_MAX_COUNT);
+
         if(sl.isEmpty()){
             m_list->hide();
             return;
@@ -243,15 +264,9 @@ void DSearchBar::setCompleter(const QString &text)
     }
     else
     {
-        QStringList sl;
-        foreach(QString word, m_historyList)
-        {
-            if(word.contains(text) && word.at(0) == text.at(0))
-            {
-                sl << word;
-            }
-        }
-        m_stringListMode->setStringList(sl);
+        cancelCompletion();
+
+        m_stringListMode->setStringList(PathCompletionEngine::match(text, m_historyList, COMPLETION_MAX_COUNT));
 //        m_list->addItems(m_stringListMode->stringList());
 
         foreach (QString itemText, m_stringListMode->stringList()) {
@@ -287,6 +302,40 @@ void DSearchBar::setCompleter(const QString &text)
     }
 }
 
+void DSearchBar::cancelCompletion()
+{
+    if (m_completionDirPath.isEmpty())
+        return;
+
+    pathCompletionEngine->cancelRequest(m_completionDirPath);
+    m_completionDirPath.clear();
+    m_completionText.clear();
+}
+
+void DSearchBar::onCompletionEntriesReady(const QString &dirPath)
+{
+    if (dirPath != m_completionDirPath)
+        return;
+
+    const QString completionText = m_completionText;
+
+    m_completionDirPath.clear();
+    m_completionText.clear();
+
+    if (completionText == text() && hasFocus())
+        showCompletion(completionText);
+}
+
+/// the listing is over, the next edit may ask for the directory again
+void DSearchBar::onCompletionEntriesFailed(const QString &dirPath)
+{
+    if (dirPath != m_completionDirPath)
+        return;
+
+    m_completionDirPath.clear();
+    m_completionText.clear();
+}
+
 void DSearchBar::completeText(QListWidgetItem *item)
 {
     qDebug() << item;
@@ -539,10 +588,15 @@ void DSearchBar::recomended(const QString& inputText)
 {
     if(m_list->count() == 1)
     {
-        m_disableCompletion = true;
         QStringList list = splitPath(m_text);
         QString modelText = m_list->item(0)->text();
         QString last = list.last();
+
+        /// a fuzzy match can't be completed inline, the typed text is not its prefix
+        if (!modelText.startsWith((isPath() || isLocalFile()) ? last : inputText))
+            return;
+
+        m_disableCompletion = true;
         if(isPath())
         {
             list.removeLast();
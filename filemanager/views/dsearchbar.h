@@ -10,6 +10,7 @@
 #include <QCompleter>
 #include <QStringListModel>
 #include <QStringList>
+#include <QSet>
 #include <QDirModel>
 #include <QPushButton>
 #include "durl.h"
@@ -43,6 +44,8 @@ private:
     void keyUpDown(int key);
     void recomended(const QString& inputText);
     void complete(const QString & str);
+    void showCompletion(const QString &text);
+    void cancelCompletion();
     QStringList splitPath(const QString &path);
     QListWidget * m_list;
     QCompleter * m_completer;
@@ -51,6 +54,7 @@ private:
     QPushButton* m_inputClearButton;
     QStringListModel * m_stringListMode;
     QStringList m_historyList;
+    QSet<QString> m_historySet;
     QDirModel * m_dirModel;
     bool m_isActive = false;
     void initConnections();
@@ -58,6 +62,8 @@ private:
     bool m_disableCompletion = false;
     bool m_searchStart = false;
     DUrl m_currentPath;
+    QString m_completionDirPath;
+    QString m_completionText;
 public slots:
     void doTextChanged(QString text);
     void searchHistoryLoaded(const QStringList &list);
@@ -69,6 +75,9 @@ public slots:
     void hideCompleter();
     void handleApplicationChanged(QWidget * old, QWidget * now);
     void setText(const QString &text);
+private slots:
+    void onCompletionEntriesReady(const QString &dirPath);
+    void onCompletionEntriesFailed(const QString &dirPath);
 protected:
     void keyPressEvent(QKeyEvent *e);
     void focusInEvent(QFocusEvent *e);
@@ -252,6 +252,9 @@ void DToolBar::searchBarTextEntered()
         else
             url = DUrl::fromSearchFile(url, text);
 
+        /// Ctrl+Enter searches inside the files
+        url.setSearchContent(Global::keyCtrlIsPressed());
+
         event = url;
     }
 
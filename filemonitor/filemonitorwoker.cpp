@@ -11,6 +11,8 @@
 #include "utils/utils.h"
 
 #include "filemanager/app/global.h"
+#include "filemanager/app/tracer.h"
+#include "filemanager/app/metrics.h"
 
 FileMonitorWoker::FileMonitorWoker(QObject *parent) :
     QObject(parent)
@@ -27,6 +29,9 @@ FileMonitorWoker::~FileMonitorWoker()
 
     close(m_inotifyFd);
 
+    m_pathToID.clear();
+    updateWatchMetrics();
+
 }
 
 void FileMonitorWoker::initInotify()
@@ -77,6 +82,8 @@ QStringList FileMonitorWoker::addPathsAction(const QStringList &paths)
         m_idToPath.insert(id, path);
     }
 
+    updateWatchMetrics();
+
     return p;
 }
 
@@ -149,11 +156,26 @@ QStringList FileMonitorWoker::removePathsAction(const QStringList &paths)
         it.remove();
     }
 
+    updateWatchMetrics();
+
     return p;
 }
 
+void FileMonitorWoker::updateWatchMetrics()
+{
+    static MetricCounter *watchCount = Metrics::instance()->gauge("filemonitor_watches", "Live inotify watches");
+
+    /// a gauge shared by all workers, each one adds its own delta
+    watchCount->add(m_pathToID.count() - m_reportedWatchCount);
+    m_reportedWatchCount = m_pathToID.count();
+}
+
 void FileMonitorWoker::readFromInotify()
 {
+    TRACE_SCOPE("FileMonitorWoker::readFromInotify");
+
+    static MetricCounter *eventCount = Metrics::instance()->counter("filemonitor_events_total", "inotify events read");
+
     int buffSize = 0;
     ioctl(m_inotifyFd, FIONREAD, (char *) &buffSize);
     QVarLengthArray<char, 4096> buffer(buffSize);
@@ -165,6 +187,7 @@ void FileMonitorWoker::readFromInotify()
     while (at < end) {
         inotify_event *event = reinterpret_cast<inotify_event *>(at);
         handleInotifyEvent(event);
+        eventCount->increment();
         if (eventForId.contains(event->wd))
             eventForId[event->wd]->mask |= event->mask;
         else
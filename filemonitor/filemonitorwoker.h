@@ -72,6 +72,7 @@ private:
     QString getPathFromID(int id) const;
     QStringList addPathsAction(const QStringList &paths);
     QStringList removePathsAction(const QStringList &paths);
+    void updateWatchMetrics();
 
 private:
     int m_inotifyFd;
@@ -80,6 +81,7 @@ private:
     QHash<QString, int> m_pathToID;
     QMultiHash<int, QString> m_idToPath;
     QMap<QString, int> m_pathReferenceCounts;
+    int m_reportedWatchCount = 0;
 };
 
 #endif // FILEMONITORWOKER_H
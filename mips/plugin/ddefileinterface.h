@@ -3,6 +3,7 @@
 #include <QtCore/qobject.h>
 #include <QString>
 #include <QList>
+#include <QStringList>
 #include <QFrame>
 class QIcon;
 
@@ -113,9 +114,26 @@ public:
 };
 
 
+class DdeFileEmblemInterface
+{
+public:
+    virtual ~DdeFileEmblemInterface() {}
+
+        /*!
+         *  \fn  void additionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons)
+         *  \brief 批量获取文件或目录图标上面的小图标，在非 GUI 线程中调用，实现必须是线程安全的
+         *  \param[ in ] const QStringList &filenames 相关的文件名列表
+         *  \param[ out ] QList<QList<QIcon> > &icons 与 filenames 一一对应，向其中追加 qicon
+         */
+    virtual void additionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons) = 0;
+};
+
+
 QT_BEGIN_NAMESPACE
 #define DdeFileInterface_iid "com.deepin.ddefileInterface"
 Q_DECLARE_INTERFACE(DdeFileInterface, DdeFileInterface_iid)
+#define DdeFileEmblemInterface_iid "com.deepin.ddefileEmblemInterface"
+Q_DECLARE_INTERFACE(DdeFileEmblemInterface, DdeFileEmblemInterface_iid)
 QT_END_NAMESPACE
 
 
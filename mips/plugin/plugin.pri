@@ -0,0 +1,6 @@
+HEADERS += \
+    $$PWD/ddefileinterface.h \
+    $$PWD/pluginmanagerapp.h
+
+SOURCES += \
+    $$PWD/pluginmanagerapp.cpp
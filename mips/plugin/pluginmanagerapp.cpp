@@ -33,9 +33,18 @@ void PluginManagerApp::loadPlugin()
         if (plugin)
         {
             DdeFileInterface *ddefileInterface = qobject_cast<DdeFileInterface *>(plugin);
+            DdeFileEmblemInterface *emblemInterface = qobject_cast<DdeFileEmblemInterface *>(plugin);
+            if (emblemInterface)
+            {
+                emblemPlugins.push_back( emblemInterface );
+            }
             if (ddefileInterface)
             {
                 plugins.push_back( ddefileInterface );
+                if (!emblemInterface)
+                {
+                    iconPlugins.push_back( ddefileInterface );
+                }
                     // Unknow空出来，从它的后面开始
                 ddefileInterface->additionalMenuInit( MenuAction::Unknow+1 + actionNames.size(  ), actionNames  ); 
             }
@@ -73,6 +82,53 @@ void PluginManagerApp::fileAdditionalIcon(const QString &filename, QList<QIcon>
     }
 }
 
+/*!
+ *  \fn  void fileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons)
+ *  \brief 批量获取 DdeFileEmblemInterface 插件的小图标，可在非 GUI 线程中调用
+ *  \param[ in ] const QStringList &filenames 相关的文件名列表
+ *  \param[ out ] QList<QList<QIcon> > &icons 与 filenames 一一对应的小图标
+ */
+void PluginManagerApp::fileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons)
+{
+    while (icons.size() < filenames.size())
+    {
+        icons << QList<QIcon>();
+    }
+
+    for( unsigned int i = 0; i < emblemPlugins.size(  ); i++ )
+    {
+        emblemPlugins[ i ]->additionalIcons( filenames, icons );
+    }
+}
+
+/*!
+ *  \fn  void legacyFileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons)
+ *  \brief 旧接口插件的小图标，只能在 GUI 线程中调用
+ *  \param[ in ] const QStringList &filenames 相关的文件名列表
+ *  \param[ out ] QList<QList<QIcon> > &icons 与 filenames 一一对应的小图标
+ */
+void PluginManagerApp::legacyFileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons)
+{
+    while (icons.size() < filenames.size())
+    {
+        icons << QList<QIcon>();
+    }
+
+        // 旧接口的插件只能逐个文件调用
+    for( unsigned int i = 0; i < iconPlugins.size(  ); i++ )
+    {
+        for( int j = 0; j < filenames.size(  ); j++ )
+        {
+            iconPlugins[ i ]->additionalIcon( filenames[ j ], icons[ j ] );
+        }
+    }
+}
+
+bool PluginManagerApp::hasLegacyIconPlugins() const
+{
+    return !iconPlugins.empty();
+}
+
 /**!
  *  \fn  void addExpandInfo( const QString &filename, QStringList &titleList, QList<QFrame *> &frames  )
  *  \brief 增加文件属性的扩展部分
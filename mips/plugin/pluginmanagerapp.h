@@ -33,6 +33,24 @@ class PluginManagerApp : public QObject
          */ 
     void fileAdditionalIcon(const QString &filename, QList<QIcon> &icons);
 
+        /*!
+         *  \fn  void fileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons)
+         *  \brief 批量获取 DdeFileEmblemInterface 插件的小图标，可在非 GUI 线程中调用
+         *  \param[ in ] const QStringList &filenames 相关的文件名列表
+         *  \param[ out ] QList<QList<QIcon> > &icons 与 filenames 一一对应的小图标
+         */
+    void fileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons);
+
+        /*!
+         *  \fn  void legacyFileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons)
+         *  \brief 旧接口插件的小图标，只能在 GUI 线程中调用
+         *  \param[ in ] const QStringList &filenames 相关的文件名列表
+         *  \param[ out ] QList<QList<QIcon> > &icons 与 filenames 一一对应的小图标
+         */
+    void legacyFileAdditionalIcons(const QStringList &filenames, QList<QList<QIcon> > &icons);
+
+    bool hasLegacyIconPlugins() const;
+
         /**!
          *  \fn  void addExpandInfo( const QString &filename, QStringList &titleList, QList<QFrame *> &frames  )
          *  \brief 增加文件属性的扩展部分
@@ -82,6 +100,8 @@ class PluginManagerApp : public QObject
     
   private:
     std::vector <DdeFileInterface *>plugins;
+    std::vector <DdeFileInterface *>iconPlugins;  //!< 未实现 DdeFileEmblemInterface 的插件
+    std::vector <DdeFileEmblemInterface *>emblemPlugins;
 };
 
 
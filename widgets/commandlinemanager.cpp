@@ -26,8 +26,12 @@ void CommandLineManager::process(){
 void CommandLineManager::initOptions(){
     QCommandLineOption newWindowOption(QStringList() << "n" << "new-window", "show new window");
     QCommandLineOption backendOption(QStringList() << "d" << "none window process", "start dde-file-manager in no window mode");
+    QCommandLineOption traceOption(QStringList() << "trace", "record trace spans and write them to <file> as Chrome trace JSON on exit, SIGUSR1 writes them too", "file");
+    QCommandLineOption metricsOption(QStringList() << "metrics", "print the metrics of the running dde-file-manager and exit");
     addOption(newWindowOption);
     addOption(backendOption);
+    addOption(traceOption);
+    addOption(metricsOption);
 }
 
 void CommandLineManager::addOption(const QCommandLineOption &option){